@@ -19,6 +19,7 @@
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <iterator>
 #include <regex>
 
 #if defined(_WIN32)
@@ -158,16 +159,31 @@ int main(int argc, char* const argv[]) {
         return 1;
       }();
       int n = 1;
-      for (const auto& file : params.files_) {
+      // Number of files ahead of the current one and bytes of each to prefetch while it is processed
+      constexpr ptrdiff_t prefetchCount = 4;
+      constexpr size_t prefetchSize = 512 * 1024;
+      auto prefetched = params.files_.begin();
+      for (auto file = params.files_.begin(); file != params.files_.end(); ++file) {
+        if (prefetched == file)
+          ++prefetched;
+        for (; prefetched != params.files_.end() && prefetched - file <= prefetchCount; ++prefetched) {
+          Exiv2::prefetchFile(*prefetched, prefetchSize);
+        }
         // If extracting to stdout then ignore verbose
         if (params.verbose_ && !(params.action_ & Action::extract && params.target_ & Params::ctStdInOut)) {
-          std::cout << _("File") << " " << std::setw(w) << std::right << n++ << "/" << filesCount << ": " << file
+          std::cout << _("File") << " " << std::setw(w) << std::right << n++ << "/" << filesCount << ": " << *file
                     << std::endl;
         }
         task->setBinary(params.binary_);
-        int ret = task->run(file);
+        if (params.stats_)
+          Exiv2::Stats::reset();
+        int ret = task->run(*file);
         if (returnCode == EXIT_SUCCESS)
           returnCode = ret;
+        if (params.stats_) {
+          std::cerr << _("Statistics for") << " " << *file << std::endl;
+          Exiv2::Stats::print(std::cerr);
+        }
       }
 
       Action::TaskFactory::instance().cleanup();
@@ -186,7 +202,7 @@ int main(int argc, char* const argv[]) {
 // class Params
 
 Params::Params() :
-    optstring_(":hVvqfbuktTFa:Y:O:D:r:p:P:d:e:i:c:m:M:l:S:g:K:n:Q:"),
+    optstring_(":hVvqfbuktTFza:Y:O:D:r:p:P:d:e:i:c:m:M:l:S:g:K:n:Q:"),
 
     target_(ctExif | ctIptc | ctComment | ctXmp),
 
@@ -271,6 +287,7 @@ void Params::help(std::ostream& os) const {
      << _("   -T      Only set the file timestamp from Exif metadata ('rename' action)\n")
      << _("   -f      Do not prompt before overwriting existing files (force)\n")
      << _("   -F      Do not prompt before renaming files (Force)\n")
+     << _("   -z      Print timing and I/O statistics for each file to stderr (stats)\n")
      << _("   -a time Time adjustment in the format [+|-]HH[:MM[:SS]]. For 'adjust' action\n")
      << _("   -Y yrs  Year adjustment with the 'adjust' action\n")
      << _("   -O mon  Month adjustment with the 'adjust' action\n")
@@ -367,6 +384,13 @@ int Params::option(int opt, const std::string& optArg, int optOpt) {
     case 'b':
       binary_ = true;
       break;
+    case 'z':
+      if (Exiv2::Stats::enabled()) {
+        stats_ = true;
+      } else {
+        std::cerr << progname() << ": " << _("Statistics are not available, exiv2lib was built without them\n");
+      }
+      break;
     case 'u':
       unknown_ = false;
       break;
@@ -1010,7 +1034,7 @@ int Params::getopt(int argc, char* const Argv[]) {
       {"--Modify", "-M"},    {"--encode", "-n"},  {"--months", "-O"},  {"--print", "-p"},    {"--Print", "-P"},
       {"--quiet", "-q"},     {"--log", "-Q"},     {"--rename", "-r"},  {"--suffix", "-S"},   {"--timestamp", "-t"},
       {"--Timestamp", "-T"}, {"--unknown", "-u"}, {"--verbose", "-v"}, {"--Version", "-V"},  {"--version", "-V"},
-      {"--years", "-Y"},
+      {"--years", "-Y"},     {"--stats", "-z"},
   };
 
   for (int i = 0; i < argc; i++) {
@@ -194,6 +194,7 @@ class Params : public Util::Getopt {
   bool verbose_{false};                           //!< Verbose (talkative) option flag.
   bool force_{false};                             //!< Force overwrites flag.
   bool binary_{false};                            //!< Suppress long binary values.
+  bool stats_{false};                             //!< Print timing and I/O statistics for each file.
   bool unknown_{true};                            //!< Suppress unknown tags.
   bool preserve_{false};                          //!< Preserve timestamps flag.
   bool timestamp_{false};                         //!< Rename also sets the file timestamp.
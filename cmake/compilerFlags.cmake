@@ -111,6 +111,18 @@ if ( MINGW OR UNIX OR MSYS ) # MINGW, Linux, APPLE, CYGWIN
                 set(CMAKE_MODULE_LINKER_FLAGS "${CMAKE_MODULE_LINKER_FLAGS} ${SANITIZER_FLAGS}")
             endif()
         endif()
+
+        if ( EXIV2_TEAM_USE_TSAN )
+            # TSAN cannot be combined with ASAN
+            if ( EXIV2_TEAM_USE_SANITIZERS )
+                message(FATAL_ERROR "EXIV2_TEAM_USE_TSAN cannot be used together with EXIV2_TEAM_USE_SANITIZERS")
+            endif()
+            set(TSAN_FLAGS "-fno-omit-frame-pointer -fsanitize=thread")
+            set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} ${TSAN_FLAGS}")
+            set(CMAKE_C_FLAGS "${CMAKE_C_FLAGS} ${TSAN_FLAGS}")
+            set(CMAKE_EXE_LINKER_FLAGS "${CMAKE_EXE_LINKER_FLAGS} ${TSAN_FLAGS}")
+            set(CMAKE_MODULE_LINKER_FLAGS "${CMAKE_MODULE_LINKER_FLAGS} ${TSAN_FLAGS}")
+        endif()
     endif()
 endif ()
 
@@ -24,6 +24,9 @@
 // Define if you want to use the inih library.
 #cmakedefine EXV_ENABLE_INIH
 
+// Define if you want the timing and I/O instrumentation of Exiv2::Stats.
+#cmakedefine EXV_ENABLE_STATS
+
 // Define if you have the strerror_r function.
 #cmakedefine EXV_HAVE_STRERROR_R
 
@@ -44,6 +47,9 @@
 // Define if you have the munmap function.
 #cmakedefine EXV_HAVE_MUNMAP
 
+// Define if you have the posix_fadvise function.
+#cmakedefine EXV_HAVE_POSIX_FADVISE
+
 /* Define if you have the <libproc.h> header file. */
 #cmakedefine EXV_HAVE_LIBPROC_H
 
@@ -53,6 +59,9 @@
 // Define if you have the <sys/mman.h> header file.
 #cmakedefine EXV_HAVE_SYS_MMAN_H
 
+// Define if you have the <sys/xattr.h> header file.
+#cmakedefine EXV_HAVE_SYS_XATTR_H
+
 // Define if you have the zlib library.
 #cmakedefine EXV_HAVE_LIBZ
 
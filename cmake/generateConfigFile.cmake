@@ -10,6 +10,7 @@ set(EXV_ENABLE_BMFF      ${EXIV2_ENABLE_BMFF})
 set(EXV_ENABLE_WEBREADY  ${EXIV2_ENABLE_WEBREADY})
 set(EXV_HAVE_LENSDATA    ${EXIV2_ENABLE_LENSDATA})
 set(EXV_ENABLE_INIH      ${EXIV2_ENABLE_INIH})
+set(EXV_ENABLE_STATS     ${EXIV2_ENABLE_STATS})
 
 set(EXV_PACKAGE_NAME     ${PROJECT_NAME})
 set(EXV_PACKAGE_VERSION  ${PROJECT_VERSION})
@@ -26,6 +27,7 @@ set(EXV_HAVE_BROTLI      ${BROTLI_FOUND})
 check_cxx_symbol_exists(mmap        sys/mman.h     EXV_HAVE_MMAP )
 check_cxx_symbol_exists(munmap      sys/mman.h     EXV_HAVE_MUNMAP )
 check_cxx_symbol_exists(strerror_r  string.h       EXV_HAVE_STRERROR_R )
+check_cxx_symbol_exists(posix_fadvise fcntl.h      EXV_HAVE_POSIX_FADVISE )
 
 check_cxx_source_compiles( "
 #include <string.h>
@@ -39,6 +41,7 @@ int main() {
 check_include_file_cxx( "libproc.h"     EXV_HAVE_LIBPROC_H )
 check_include_file_cxx( "unistd.h"      EXV_HAVE_UNISTD_H )
 check_include_file_cxx( "sys/mman.h"    EXV_HAVE_SYS_MMAN_H )
+check_include_file_cxx( "sys/xattr.h"   EXV_HAVE_SYS_XATTR_H )
 
 set(EXV_ENABLE_NLS ${EXIV2_ENABLE_NLS})
 set(EXV_ENABLE_VIDEO ${EXIV2_ENABLE_VIDEO})
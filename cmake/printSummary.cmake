@@ -56,6 +56,7 @@ OptionOutput( "Native language support:            " EXIV2_ENABLE_NLS
 OptionOutput( "Building video support:             " EXIV2_ENABLE_VIDEO                 )
 OptionOutput( "Nikon lens database:                " EXIV2_ENABLE_LENSDATA              )
 OptionOutput( "Building webready support:          " EXIV2_ENABLE_WEBREADY              )
+OptionOutput( "Building instrumentation (Stats):   " EXIV2_ENABLE_STATS                 )
 if    ( EXIV2_ENABLE_WEBREADY )
     OptionOutput( "USE Libcurl for HttpIo:             " EXIV2_ENABLE_CURL              )
 endif ( EXIV2_ENABLE_WEBREADY )
@@ -143,13 +143,17 @@ class EXIV2API AsfVideo : public Image {
 
  private:
   //! Variable to check the end of metadata traversing.
-  bool continueTraversing_;
+  bool continueTraversing_{};
   //! Variable which stores current position of the read pointer.
-  uint64_t localPosition_;
+  uint64_t localPosition_{};
   //! Variable which stores current stream being processsed.
-  int streamNumber_;
+  int streamNumber_{};
+  //! Variable which stores the stream of the previous Extended Stream Properties object.
+  int previousStream_{0};
   //! Variable to store height and width of a video frame.
-  uint64_t height_, width_;
+  uint64_t height_{}, width_{};
+  //! Collects the decoded properties, merged into xmpData_ at the end of readMetadata()
+  XmpDataBuilder xmp_;
 
 };  // Class AsfVideo
 
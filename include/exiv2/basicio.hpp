@@ -391,10 +391,17 @@ class EXIV2API FileIo : public BasicIo {
         the \em src BasicIo object into the empty file.
 
     This method is optimized to simply rename the source file if the
-    source object is another FileIo instance. The source BasicIo object
-    is invalidated by this operation and should not be used after this
-    method returns. This method exists primarily to be used with
-    the BasicIo::temporary() method.
+    source object is another FileIo instance. On POSIX systems, other
+    sources are written to a new temporary file in the same directory,
+    which gets the owner, group, permissions, extended attributes and
+    access time of the file and then replaces it with a rename, so the
+    file is never seen truncated or partly written. Files which are
+    symbolic links, have several hard links, belong to another user or
+    whose attributes cannot be copied are overwritten in place instead,
+    as are all files on Windows. The source
+    BasicIo object is invalidated by this operation and should not be
+    used after this method returns. This method exists primarily to be
+    used with the BasicIo::temporary() method.
 
     @note If the caller doesn't have permissions to write to the file,
         an exception is raised and \em src is deleted.
@@ -474,6 +481,14 @@ class EXIV2API FileIo : public BasicIo {
   FileIo& operator=(const FileIo&) = delete;
 
  private:
+  /*!
+    @brief Write the data of \em src to a temporary file next to this file,
+        copy the attributes of this file to it and rename it over this file.
+    @return false if this file must be overwritten in place instead
+    @throw Error if writing or renaming the temporary file fails
+   */
+  bool stageAndReplace(BasicIo& src);
+
   // Pimpl idiom
   class Impl;
   std::unique_ptr<Impl> p_;
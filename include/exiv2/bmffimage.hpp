@@ -8,8 +8,6 @@
 // included header files
 #include "image.hpp"
 
-#include <set>
-
 // *****************************************************************************
 // namespace extensions
 namespace Exiv2 {
@@ -104,6 +102,12 @@ class EXIV2API BmffImage : public Image {
   void setXmpData(const XmpData&) override;
   void setComment(const std::string& comment) override;
   void printStructure(std::ostream& out, Exiv2::PrintStructureOption option, size_t depth) override;
+  /*!
+    @brief Set the limit for the uncompressed size of a JPEG XL brob box.
+        readMetadata() throws Error(ErrorCode::kerFailedToReadImageData)
+        for larger boxes. The default is defaultBrotliMaxSize.
+   */
+  void setBrotliMaxSize(size_t size);
   //@}
 
   //! @name Accessors
@@ -111,12 +115,19 @@ class EXIV2API BmffImage : public Image {
   [[nodiscard]] std::string mimeType() const override;
   [[nodiscard]] uint32_t pixelWidth() const override;
   [[nodiscard]] uint32_t pixelHeight() const override;
+  //! Return the limit for the uncompressed size of a JPEG XL brob box
+  [[nodiscard]] size_t brotliMaxSize() const;
   //@}
 
+  //! Default limit for the uncompressed size of a JPEG XL brob box
+  static constexpr size_t defaultBrotliMaxSize = 32 * 1024 * 1024;
+
   const Exiv2::ByteOrder endian_{Exiv2::bigEndian};
 
  private:
   void openOrThrow();
+  //! Forget the brand of the previous file and whether its metadata was read
+  void doReopen() override;
   /*!
     @brief recursiveBoxHandler
     @throw Error if we visit a box more than once
@@ -128,13 +139,16 @@ class EXIV2API BmffImage : public Image {
   uint64_t boxHandler(std::ostream& out, Exiv2::PrintStructureOption option, uint64_t pbox_end, size_t depth);
 
   uint32_t fileType_{0};
-  std::set<size_t> visits_;
+  size_t lastVisit_{0};  //!< Address of the box visited last; boxes are visited in ascending order
+  uint64_t visits_{0};
   uint64_t visits_max_{0};
   uint16_t unknownID_{0xffff};
   uint16_t exifID_{0xffff};
   uint16_t xmpID_{0};
   std::map<uint32_t, Iloc> ilocs_;
   bool bReadMetadata_{false};
+  size_t printTop_{0};                          //!< Depth of the top-level boxes in printStructure()
+  size_t brotliMaxSize_{defaultBrotliMaxSize};  //!< Limit for the uncompressed size of a brob box
   //@}
 
   /*!
@@ -146,11 +160,14 @@ class EXIV2API BmffImage : public Image {
   static bool fullBox(uint32_t box);
   static std::string uuidName(const Exiv2::DataBuf& uuid);
 
+#ifdef EXV_HAVE_BROTLI
   /*!
     @brief Wrapper around brotli to uncompress JXL brob content.
+    @param maxSize Limit for the uncompressed size; larger content throws
+        Error(ErrorCode::kerFailedToReadImageData).
    */
-#ifdef EXV_HAVE_BROTLI
-  static void brotliUncompress(const byte* compressedBuf, size_t compressedBufSize, DataBuf& arr);
+  static void brotliUncompress(const byte* compressedBuf, size_t compressedBufSize, DataBuf& arr,
+                               size_t maxSize = defaultBrotliMaxSize);
 #endif
 
 };  // class BmffImage
@@ -16,6 +16,7 @@
 
 #include "config.h"
 
+#include <atomic>     // for atomic
 #include <exception>  // for exception
 #include <sstream>    // for operator<<, ostream, ostringstream, bas...
 #include <string>     // for basic_string, string
@@ -116,9 +117,9 @@ class EXIV2API LogMsg {
  private:
   // DATA
   // The output level. Only messages with type >= level_ will be written
-  static Level level_;
+  static std::atomic<Level> level_;
   // The log handler in use
-  static Handler handler_;
+  static std::atomic<Handler> handler_;
   // The type of this log message
   const Level msgType_;
   // Holds the log message until it is passed to the message handler
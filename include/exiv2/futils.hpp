@@ -84,6 +84,22 @@ EXIV2API Protocol fileProtocol(const std::string& path);
  */
 EXIV2API bool fileExists(const std::string& path);
 
+/*!
+  @brief Ask the operating system to start reading the first \em length
+         bytes of a local file in the background.
+
+  This is a hint only, nothing is read into the process. Applications which
+  scan many files can call it for the next file while the current one is
+  parsed, so that its header is already in the page cache when it is opened.
+  The function does nothing for remote paths, for anything that is not a
+  regular file, such as a FIFO or a device, or on platforms without
+  posix_fadvise(). It never blocks on the file.
+
+  @param path   Name of the file to prefetch.
+  @param length Number of bytes from the start of the file to prefetch.
+ */
+EXIV2API void prefetchFile(const std::string& path, size_t length);
+
 /*!
   @brief Return a system error message and the error code (errno).
          See %strerror(3).
@@ -13,6 +13,8 @@
 #include "iptc.hpp"
 #include "xmp_exiv2.hpp"
 
+#include <limits>
+
 // *****************************************************************************
 // namespace extensions
 namespace Exiv2 {
@@ -37,6 +39,26 @@ using NativePreviewList = std::vector<NativePreview>;
  */
 enum PrintStructureOption { kpsNone, kpsBasic, kpsXMP, kpsRecursive, kpsIccProfile, kpsIptcErase };
 
+/*!
+  @brief Limits applied by printStructure() for kpsBasic and kpsRecursive, to
+         bound the cost of dumping very large files. The defaults do not limit
+         anything. Elided entries are marked with "..." in the output.
+ */
+struct PrintStructureLimits {
+  /*!
+    @brief Nesting depth below the top-level structure beyond which directories
+           and boxes are not printed. 0 prints the top level only. The IFDs of
+           Exif data embedded in a JPEG 2000 file count from their first IFD.
+   */
+  size_t maxDepth_{std::numeric_limits<size_t>::max()};
+  //! Maximum number of entries printed per directory, chunk list or box
+  size_t maxEntries_{std::numeric_limits<size_t>::max()};
+  //! Maximum number of bytes read from the file to print values
+  size_t maxBytes_{std::numeric_limits<size_t>::max()};
+  //! Chunk or box types (e.g. "IDAT", "mdat") which are not printed
+  std::vector<std::string> skipTypes_;
+};
+
 /*!
   @brief Abstract base class defining the interface for an image. This is
      the top-level interface to the Exiv2 library.
@@ -222,6 +244,24 @@ class EXIV2API Image {
         from the actual image until the writeMetadata() method is called.
    */
   virtual void clearMetadata();
+  /*!
+    @brief Reuse this image for another file of the same type, read through \em io.
+
+    Releases the current IO and erases all buffered metadata and the state
+    kept about the previous file, as if the image had just been created by
+    ImageFactory::open(). Unlike a new image, the metadata containers and
+    strings keep the storage they have already allocated, which saves
+    allocations when many files are processed one after the other.
+
+    The new file is not accessed until readMetadata() is called, which
+    throws if it is not of the type of this image.
+   */
+  void reopen(BasicIo::UniquePtr io);
+  /*!
+    @brief Reuse this image for the file at \em path, see reopen(BasicIo::UniquePtr).
+        If the image reads a local file, its FileIo is reused as well.
+   */
+  void reopen(const std::string& path);
   /*!
     @brief Returns an ExifData instance containing currently buffered
         Exif data.
@@ -301,6 +341,12 @@ class EXIV2API Image {
   void printIFDStructure(BasicIo& io, std::ostream& out, Exiv2::PrintStructureOption option, size_t start, bool bSwap,
                          char c, size_t depth);
 
+  //! Set the limits applied by printStructure()
+  void setPrintStructureLimits(const PrintStructureLimits& limits);
+
+  //! Return the limits applied by printStructure()
+  [[nodiscard]] const PrintStructureLimits& printStructureLimits() const;
+
   /*!
     @brief is the host platform bigEndian
    */
@@ -471,6 +517,13 @@ class EXIV2API Image {
   uint32_t pixelHeight_{0};           //!< image pixel height
   NativePreviewList nativePreviews_;  //!< list of native previews
 
+  /*!
+    @brief Reset the state a subclass keeps about the current file. Called by
+        reopen() once the new IO is in place and the metadata is cleared.
+   */
+  virtual void doReopen() {
+  }
+
   //! Return tag name for given tag id.
   const std::string& tagName(uint16_t tag);
 
@@ -491,6 +544,15 @@ class EXIV2API Image {
   std::map<int, std::string> tags_;  //!< Map of tags
   bool init_{true};                  //!< Flag marking if map of tags needs to be initialized
 
+  PrintStructureLimits printStructureLimits_;  //!< Limits applied by printStructure()
+
+  //! State of one printIFDStructure() call, shared by the IFDs it recurses into
+  struct IfdPrintState;
+
+  //! Print out the structure of a TIFF IFD and of the IFDs it refers to
+  void printIFDStructure(BasicIo& io, std::ostream& out, Exiv2::PrintStructureOption option, size_t start, bool bSwap,
+                         char c, size_t depth, IfdPrintState& state);
+
 };  // class Image
 
 //! Type for function pointer that creates new Image instances
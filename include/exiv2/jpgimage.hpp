@@ -130,7 +130,12 @@ class EXIV2API JpegBase : public Image {
   [[nodiscard]] byte advanceToMarker(ErrorCode err) const;
   //@}
 
-  DataBuf readNextSegment(byte marker);
+  /*!
+    @brief Read the segment which starts after \em marker into \em buf.
+        The storage of \em buf is reused, so callers which walk all
+        segments only allocate for the largest segment.
+   */
+  void readNextSegment(byte marker, DataBuf& buf);
 };
 
 /*!
@@ -26,6 +26,9 @@
 // included header files
 #include "image.hpp"
 
+#include <utility>
+#include <vector>
+
 // *****************************************************************************
 // namespace extensions
 namespace Exiv2 {
@@ -127,13 +130,24 @@ class EXIV2API MatroskaVideo : public Image {
   //@{
   void readMetadata() override;
   void writeMetadata() override;
+  /*!
+    @brief Set the size of the largest element value that readMetadata()
+        decodes into XMP. Larger values are skipped with a warning.
+        The default is defaultValueMaxSize.
+   */
+  void setValueMaxSize(size_t size);
   //@}
 
   //! @name Accessors
   //@{
   [[nodiscard]] std::string mimeType() const override;
+  //! Return the size of the largest element value that is decoded into XMP
+  [[nodiscard]] size_t valueMaxSize() const;
   //@}
 
+  //! Default of the largest element value that is decoded into XMP
+  static constexpr size_t defaultValueMaxSize = 64 * 1024;
+
  protected:
   /*!
     @brief Function used to calulate the size of a block.
@@ -150,6 +164,14 @@ class EXIV2API MatroskaVideo : public Image {
         Calls contentManagement() or skips to next tag, if required.
    */
   void decodeBlock();
+  /*!
+    @brief Continue behind the media data: seek to the next Info, Tracks,
+        Tags or Attachments element located after \em pos according to
+        the SeekHead.
+    @param pos Position of the Cluster or Cues element just reached.
+    @return true if such an element exists and the IO position was moved to it.
+   */
+  bool seekToNextElement(size_t pos);
   /*!
     @brief Interpret tag information, and save it in the respective XMP container.
     @param mt Pointer to current tag,
@@ -171,13 +193,26 @@ class EXIV2API MatroskaVideo : public Image {
 
  private:
   //! Variable to check the end of metadata traversing.
-  bool continueTraversing_;
+  bool continueTraversing_{};
+  //! Collects the decoded properties, merged into xmpData_ at the end of readMetadata()
+  XmpDataBuilder xmp_;
   //! Variable to store height and width of a video frame.
-  uint64_t height_;
-  uint64_t width_;
-  uint32_t track_count_;
+  uint64_t height_{};
+  uint64_t width_{};
+  uint32_t track_count_{};
   double time_code_scale_ = 1.0;
   uint64_t stream_ = 0;
+  //! Start of the segment data, the origin of SeekHead positions
+  uint64_t segmentStart_ = 0;
+  //! Element ID of the SeekHead entry being read
+  uint64_t seekId_ = 0;
+  //! Element IDs and segment-relative positions listed in the SeekHead
+  std::vector<std::pair<uint64_t, uint64_t>> seekEntries_;
+  //! MIME type of the attachment being read
+  std::string attachFileMime_;
+
+  //! Values larger than this are skipped instead of being decoded into XMP
+  size_t valueMaxSize_ = defaultValueMaxSize;
 
   static constexpr double bytesMB = 1048576;
 
@@ -77,6 +77,8 @@ class EXIV2API PngImage : public Image {
 
    */
   void doWriteMetadata(BasicIo& outIo);
+  //! Forget the ICC profile name of the previous file
+  void doReopen() override;
   //@}
 
   std::string profileName_;
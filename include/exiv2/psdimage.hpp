@@ -84,6 +84,13 @@ class EXIV2API PsdImage : public Image {
     @return 4 if opening or writing to the associated BasicIo fails
    */
   void doWriteMetadata(BasicIo& outIo);
+  /*!
+    @brief Write the image resource blocks of the original file to \em outIo,
+          replacing or inserting the IPTC, Exif and XMP blocks.
+          The input is expected to be positioned at the first resource block.
+    @return Length of the resource section written
+   */
+  uint32_t writeResourceBlocks(BasicIo& outIo, uint32_t oldResLength);
   uint32_t writeExifData(const ExifData& exifData, BasicIo& out);
   //@}
 
@@ -27,6 +27,11 @@
 #include "exif.hpp"
 #include "image.hpp"
 
+// + standard includes
+#include <array>
+#include <utility>
+#include <vector>
+
 // *****************************************************************************
 // namespace extensions
 namespace Exiv2 {
@@ -34,10 +39,36 @@ namespace Exiv2 {
 // *****************************************************************************
 // class definitions
 
+//! Location and presentation time of a sample of a timed metadata track
+struct TimedSample {
+  uint64_t offset_;  //!< File offset of the sample data
+  uint32_t size_;    //!< Size of the sample data in bytes
+  double time_;      //!< Presentation time in seconds
+  double duration_;  //!< Duration in seconds
+};
+
+/*!
+  @brief Timed metadata track, e.g. GoPro GPMF ("gpmd"), Google CAMM ("camm"),
+      Apple "mebx" or Sony "rtmd". Only the location of the samples is kept,
+      the sample data is read on request by QuickTimeVideo::readSamples().
+ */
+struct TimedMetadataTrack {
+  std::string format_;                //!< Sample entry format
+  std::vector<TimedSample> samples_;  //!< Samples in decoding order
+};
+
+//! A position of a GPS track
+struct GpsPoint {
+  double time_;       //!< Presentation time in seconds
+  double latitude_;   //!< Latitude in degrees, positive north
+  double longitude_;  //!< Longitude in degrees, positive east
+  double altitude_;   //!< Altitude in meters
+};
+
 /*!
   @brief Class to access QuickTime video files.
  */
-class QuickTimeVideo : public Image {
+class EXIV2API QuickTimeVideo : public Image {
  public:
   //! @name Creators
   //@{
@@ -67,11 +98,27 @@ class QuickTimeVideo : public Image {
   //@{
   void readMetadata() override;
   void writeMetadata() override;
+  /*!
+    @brief Read \em count samples of \em track, starting with sample
+        \em first. Samples stored back to back in the file are fetched
+        with a single read.
+    @return The sample data, one buffer per sample.
+    @throw Error if the samples cannot be read.
+   */
+  std::vector<DataBuf> readSamples(const TimedMetadataTrack& track, size_t first, size_t count);
+  /*!
+    @brief Decode the GPS positions recorded in the timed metadata tracks.
+        GoPro GPMF "GPS5" streams and CAMM position (type 5) and GPS
+        (type 6) packets are supported.
+   */
+  std::vector<GpsPoint> gpsTrack();
   //@}
 
   //! @name Accessors
   //@{
   std::string mimeType() const override;
+  //! Timed metadata tracks found by readMetadata()
+  [[nodiscard]] const std::vector<TimedMetadataTrack>& timedMetadataTracks() const;
   //@}
 
  protected:
@@ -189,6 +236,18 @@ class QuickTimeVideo : public Image {
         and save it in the respective XMP container.
    */
   void timeToSampleDecoder();
+  /*!
+    @brief Read a sample size, sample to chunk or chunk offset table
+        of a timed metadata track.
+    @param buf Data buffer which contains the tag ID.
+    @param size Size of the data block used to store the table.
+   */
+  void sampleTableDecoder(Exiv2::DataBuf& buf, size_t size);
+  /*!
+    @brief Locate the samples of the timed metadata track decoded last
+        and add it to timedMetadataTracks_.
+   */
+  void addTimedMetadataTrack();
   /*!
     @brief Recognizes which stream is currently under processing,
         and save its information in currentStream_ .
@@ -212,9 +271,24 @@ class QuickTimeVideo : public Image {
   int currentStream_ = 0;
   //! Variable to check the end of metadata traversing.
   bool continueTraversing_ = false;
+  //! Collects the decoded properties, merged into xmpData_ at the end of readMetadata()
+  XmpDataBuilder xmp_;
   //! Variable to store height and width of a video frame.
   uint64_t height_ = 0, width_ = 0;
 
+  //! Sample tables of the timed metadata track being decoded
+  struct SampleTable {
+    std::string format_;
+    uint64_t timeScale_ = 0;
+    std::vector<std::pair<uint32_t, uint32_t>> timeToSample_;  //!< Sample count, sample delta
+    std::vector<std::array<uint32_t, 2>> sampleToChunk_;       //!< First chunk, samples per chunk
+    std::vector<uint64_t> chunkOffsets_;
+    std::vector<uint32_t> sampleSizes_;  //!< Empty if all samples have sampleSize_
+    uint32_t sampleSize_ = 0;
+    uint32_t sampleCount_ = 0;
+  } sampleTable_;
+  std::vector<TimedMetadataTrack> timedMetadataTracks_;
+
 };  // QuickTimeVideo End
 
 // *****************************************************************************
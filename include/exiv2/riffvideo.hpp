@@ -115,8 +115,10 @@ class EXIV2API RiffVideo : public Image {
   void aviHeaderTagsHandler(size_t size);
   /*!
     @brief Interpret Riff List tag information, and save it
-        in the respective XMP container.
-    @param size Size of the data block used to store Tag Information.
+        in the respective XMP container. Only the hdrl, strl, INFO,
+        ncdt and odml lists are read, other lists such as movi are
+        skipped by their size.
+    @param size Size of the list, including the list type.
    */
   void listHandler(size_t size);
   /*!
@@ -128,20 +130,21 @@ class EXIV2API RiffVideo : public Image {
   /*!
     @brief Interpret INFO tag information, and save it
         in the respective XMP container.
+    @param size Size of the list, including the list type.
    */
-  void infoTagsHandler();
+  void infoTagsHandler(size_t size);
   /*!
     @brief Interpret Nikon Tags related to Video information, and
         save it in the respective XMP container.
+    @param size Size of the list, including the list type.
    */
-  void nikonTagsHandler();
+  void nikonTagsHandler(size_t size);
   /*!
     @brief Interpret OpenDML tag information, and save it
         in the respective XMP container.
+    @param size Size of the list, including the list type.
    */
-  void odmlTagsHandler();
-  //! @brief Skips Particular Blocks of Metadata List.
-  void skipListData();
+  void odmlTagsHandler(size_t size);
   /*!
     @brief Interprets DateTimeOriginal tag or stream name tag
         information, and save it in the respective XMP container.
@@ -181,9 +184,13 @@ class EXIV2API RiffVideo : public Image {
   static constexpr auto RIFF_CHUNK_HEADER_EXIF = "EXIF";
   static constexpr auto RIFF_CHUNK_HEADER_XMP = "XMP ";
   //! Variable to check the end of metadata traversing.
-  bool continueTraversing_;
+  bool continueTraversing_{};
+  //! True once a list has been read completely, JUNK chunks are only decoded after that.
+  bool listEnd_ = false;
+  //! Collects the decoded properties, merged into xmpData_ at the end of readMetadata()
+  XmpDataBuilder xmp_;
   //! Variable which stores current stream being processsed.
-  int streamType_;
+  int streamType_{};
 
 };  // Class RiffVideo
 
@@ -0,0 +1,70 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef STATS_HPP_
+#define STATS_HPP_
+
+// *****************************************************************************
+#include "exiv2lib_export.h"
+
+// included header files
+#include "config.h"
+
+// + standard includes
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// *****************************************************************************
+// namespace extensions
+namespace Exiv2 {
+// *****************************************************************************
+// class definitions
+
+/*!
+  @brief Timings and I/O counters collected by the library while it parses and
+         encodes metadata.
+
+  The instrumentation is only compiled in when the library is configured with
+  EXIV2_ENABLE_STATS, see enabled(). The statistics are kept per thread: each
+  call returns what the calling thread has collected since the last reset(),
+  so that an application can attribute the cost of an operation to the file
+  it processed.
+ */
+class EXIV2API Stats {
+ public:
+  //! Time spent in one phase, for example "ImageFactory::open" or "TiffParserWorker::decode"
+  struct Phase {
+    std::string name_;               //!< Name of the phase, nested phases are named "parent/child"
+    size_t depth_;                   //!< Nesting depth, 0 for a top-level phase
+    uint64_t calls_;                 //!< Number of times the phase was entered
+    std::chrono::nanoseconds time_;  //!< Time spent in the phase, including its nested phases
+  };
+
+  //! I/O and allocation counters
+  struct Counters {
+    uint64_t reads_{0};           //!< Number of BasicIo reads
+    uint64_t bytesRead_{0};       //!< Number of bytes read through BasicIo
+    uint64_t seeks_{0};           //!< Number of BasicIo seeks
+    uint64_t writes_{0};          //!< Number of BasicIo writes
+    uint64_t bytesWritten_{0};    //!< Number of bytes written through BasicIo
+    uint64_t allocations_{0};     //!< Number of DataBuf allocations
+    uint64_t bytesAllocated_{0};  //!< Number of bytes allocated by DataBuf
+  };
+
+  //! Return true if the library was built with the instrumentation
+  static bool enabled();
+  //! Clear the statistics of the calling thread
+  static void reset();
+  //! Return the phases of the calling thread, in the order they were first entered
+  static std::vector<Phase> phases();
+  //! Return the counters of the calling thread
+  static Counters counters();
+  //! Print the phases and counters of the calling thread
+  static void print(std::ostream& os);
+};
+
+}  // namespace Exiv2
+
+#endif  // #ifndef STATS_HPP_
@@ -78,6 +78,9 @@ class EXIV2API TiffImage : public Image {
   //@}
 
  private:
+  //! Forget the primary image and MIME type of the previous file
+  void doReopen() override;
+
   //! @name Accessors
   //@{
   //! Return the group name of the group with the primary image.
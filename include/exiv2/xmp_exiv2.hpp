@@ -10,6 +10,11 @@
 #include "metadatum.hpp"
 #include "properties.hpp"
 
+// + standard includes
+#include <atomic>
+#include <map>
+#include <vector>
+
 // *****************************************************************************
 // namespace extensions
 namespace Exiv2 {
@@ -161,6 +166,11 @@ class EXIV2API XmpData {
            member function.
    */
   Xmpdatum& operator[](const std::string& key);
+  /*!
+    @brief Same as operator[](const std::string&) for an already parsed
+           \em key. Use this to avoid parsing the same key repeatedly.
+   */
+  Xmpdatum& operator[](const XmpKey& key);
   /*!
     @brief Add an %Xmpdatum from the supplied key and value pair. This
            method copies (clones) the value.
@@ -242,12 +252,85 @@ class EXIV2API XmpData {
   //@}
 
  private:
+  friend class XmpDataBuilder;
+
   // DATA
   XmpMetadata xmpMetadata_;
   std::string xmpPacket_;
   bool usePacket_{};
 };  // class XmpData
 
+/*!
+  @brief Append-only helper to add many properties to an %XmpData container.
+
+  operator[] appends a new %Xmpdatum without searching the container, and
+  each distinct key string is parsed only once. finish() merges the
+  properties added through the builder that have the same key: the first
+  occurrence of a key keeps its position and receives the value assigned
+  last. Properties added to the container directly, e.g. with XmpData::add(),
+  are left alone. Until finish() is called, the container must only be
+  appended to.
+ */
+class EXIV2API XmpDataBuilder {
+ public:
+  //! @name Creators
+  //@{
+  //! Constructor, properties are added to \em xmpData
+  explicit XmpDataBuilder(XmpData& xmpData);
+  XmpDataBuilder(const XmpDataBuilder&) = delete;
+  XmpDataBuilder& operator=(const XmpDataBuilder&) = delete;
+  //@}
+
+  //! @name Manipulators
+  //@{
+  /*!
+    @brief Append an %Xmpdatum with the given \em key and return a
+           reference to it. The reference is only valid until the next
+           property is added.
+   */
+  Xmpdatum& operator[](const std::string& key);
+  //! Merge the properties added through the builder that have the same key
+  void finish();
+  //@}
+
+ private:
+  //! Return the parsed key for \em key, parsing it on first use
+  const XmpKey& xmpKey(const std::string& key);
+
+  // DATA
+  XmpData& xmpData_;
+  std::map<std::string, XmpKey, std::less<>> keys_;
+  std::vector<size_t> added_;  //!< Positions of the properties added since the last finish()
+};  // class XmpDataBuilder
+
+/*!
+  @brief Utility class that calls XmpDataBuilder::finish() upon destruction.
+      Meant to be used as a stack variable in functions that add properties
+      through an XmpDataBuilder, so that they are merged even if an
+      exception is thrown.
+ */
+class EXIV2API XmpDataFinisher {
+ public:
+  //! @name Creators
+  //@{
+  //! Constructor, takes an XmpDataBuilder reference
+  explicit XmpDataFinisher(XmpDataBuilder& builder) : builder_(builder) {
+  }
+  /*!
+    @brief Destructor, finishes the XmpDataBuilder. An exception thrown by
+           XmpDataBuilder::finish() is reported as a warning and not
+           propagated; the repeated keys are then left unmerged.
+   */
+  ~XmpDataFinisher();
+  XmpDataFinisher(const XmpDataFinisher&) = delete;
+  XmpDataFinisher& operator=(const XmpDataFinisher&) = delete;
+  //@}
+
+ private:
+  // DATA
+  XmpDataBuilder& builder_;
+};  // class XmpDataFinisher
+
 /*!
   @brief Stateless parser class for XMP packets. Images use this
          class to parse and serialize XMP packets. The parser uses
@@ -387,7 +470,7 @@ class EXIV2API XmpParser {
   static void registeredNamespaces(Exiv2::Dictionary&);
 
   // DATA
-  static bool initialized_;  //! Indicates if the XMP Toolkit has been initialized
+  static std::atomic<bool> initialized_;  //! Indicates if the XMP Toolkit has been initialized
   static XmpLockFct xmpLockFct_;
   static void* pLockData_;
 
@@ -0,0 +1,95 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Compare the allocations and time per file of ImageFactory::open() and Image::reopen()
+
+#include <exiv2/exiv2.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+namespace {
+uint64_t allocations = 0;
+
+//! Read the metadata of all files \em rounds times, return the number of files read
+template <typename ReadFct>
+size_t run(const std::vector<std::string>& files, int rounds, ReadFct readFile) {
+  size_t count = 0;
+  for (int round = 0; round < rounds; ++round) {
+    for (const auto& file : files) {
+      readFile(file);
+      ++count;
+    }
+  }
+  return count;
+}
+
+//! Run \em readFile over all files and print the allocations and time per file
+template <typename ReadFct>
+void report(const char* label, const std::vector<std::string>& files, int rounds, ReadFct readFile) {
+  const uint64_t before = allocations;
+  const auto start = std::chrono::steady_clock::now();
+  const size_t count = run(files, rounds, readFile);
+  const std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+  std::cout << label << ": " << (allocations - before) / count << " allocations/file, " << elapsed.count() / count
+            << " us/file\n";
+}
+}  // namespace
+
+// Count all allocations of the program, including those made by the library
+void* operator new(size_t size) {
+  ++allocations;
+  if (void* p = std::malloc(size == 0 ? 1 : size))
+    return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+  std::free(p);
+}
+
+int main(int argc, char* const argv[]) {
+  Exiv2::XmpParser::initialize();
+  ::atexit(Exiv2::XmpParser::terminate);
+#ifdef EXV_ENABLE_BMFF
+  Exiv2::enableBMFF();
+#endif
+
+  if (argc < 3) {
+    std::cout << "Usage: " << argv[0] << " rounds file...\n"
+              << "Read the metadata of files of the same type rounds times, first with a new image for\n"
+              << "each file, then reusing one image, and print the allocations and time per file\n";
+    return EXIT_FAILURE;
+  }
+
+  try {
+    const int rounds = std::atoi(argv[1]);
+    const std::vector<std::string> files(argv + 2, argv + argc);
+    if (rounds <= 0) {
+      std::cerr << argv[0] << ": rounds must be positive\n";
+      return EXIT_FAILURE;
+    }
+
+    // warm up static tables so that they are not charged to the first run
+    run(files, 1, [](const std::string& file) { Exiv2::ImageFactory::open(file)->readMetadata(); });
+
+    report("open  ", files, rounds, [](const std::string& file) {
+      auto image = Exiv2::ImageFactory::open(file);
+      image->readMetadata();
+    });
+
+    auto image = Exiv2::ImageFactory::open(files.front());
+    report("reopen", files, rounds, [&image](const std::string& file) {
+      image->reopen(file);
+      image->readMetadata();
+    });
+  } catch (Exiv2::Error& e) {
+    std::cerr << "Caught Exiv2 exception '" << e << "'\n";
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
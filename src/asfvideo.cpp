@@ -34,14 +34,19 @@
 #include "error.hpp"
 #include "futils.hpp"
 #include "helper_functions.hpp"
+#include "stats_int.hpp"
 #include "tags.hpp"
 #include "tags_int.hpp"
 #include "types.hpp"
+#include "utils.hpp"
 
 // + standard includes
+#include <algorithm>
+#include <array>
 #include <cassert>
 #include <cctype>
 #include <cstring>
+#include <string_view>
 
 // *****************************************************************************
 // class member definitions
@@ -148,6 +153,98 @@ constexpr const TagVocabulary GUIDReferenceTags[] = {
     {"6698B84E-0AFA-4330-AEB2-1C0A98D7A44D", "Payload_Extension_System_Encryption_Sample_ID"},
     {"00E1AF06-7BEC-11D1-A582-00C04FC29CFB", "Payload_Extension_System_Degradable_JPEG"}};
 
+//! GUID as stored in the file: the first three fields little-endian, the rest in string order
+using AsfGuid = std::array<byte, 16>;
+
+/*!
+  @brief Convert a GUID string like "75B22630-668E-11CF-A6D9-00AA0062CE6C"
+      to the 16 bytes stored in an ASF file.
+ */
+constexpr AsfGuid toGUID(std::string_view str) {
+  // position in the string of the two hex digits of each byte
+  constexpr size_t pos[] = {6, 4, 2, 0, 11, 9, 16, 14, 19, 21, 24, 26, 28, 30, 32, 34};
+  AsfGuid guid{};
+  for (size_t i = 0; i < guid.size(); ++i) {
+    guid[i] = static_cast<byte>(hexDigitValues[static_cast<uint8_t>(str[pos[i]])] << 4 |
+                                hexDigitValues[static_cast<uint8_t>(str[pos[i] + 1])]);
+  }
+  return guid;
+}
+
+//! ASF objects and stream types which are decoded, all others are skipped
+enum class AsfObject {
+  Other,
+  Header,
+  FileProperties,
+  StreamProperties,
+  Metadata,
+  ExtendedContentDescription,
+  MetadataLibrary,
+  CodecList,
+  ContentDescription,
+  ExtendedStreamProperties,
+  HeaderExtension,
+  LanguageList,
+  AudioMedia,
+  VideoMedia,
+};
+
+constexpr AsfObject asfObject(std::string_view label) {
+  if (label == "Header")
+    return AsfObject::Header;
+  if (label == "File_Properties")
+    return AsfObject::FileProperties;
+  if (label == "Stream_Properties")
+    return AsfObject::StreamProperties;
+  if (label == "Metadata")
+    return AsfObject::Metadata;
+  if (label == "Extended_Content_Description")
+    return AsfObject::ExtendedContentDescription;
+  if (label == "Metadata_Library")
+    return AsfObject::MetadataLibrary;
+  if (label == "Codec_List")
+    return AsfObject::CodecList;
+  if (label == "Content_Description")
+    return AsfObject::ContentDescription;
+  if (label == "Extended_Stream_Properties")
+    return AsfObject::ExtendedStreamProperties;
+  if (label == "Header_Extension")
+    return AsfObject::HeaderExtension;
+  if (label == "Language_List")
+    return AsfObject::LanguageList;
+  if (label == "Audio_Media")
+    return AsfObject::AudioMedia;
+  if (label == "Video_Media")
+    return AsfObject::VideoMedia;
+  return AsfObject::Other;
+}
+
+//! Binary form of GUIDReferenceTags, so that objects are identified without formatting their GUID
+struct GUIDReference {
+  AsfGuid guid_;
+  AsfObject object_;
+};
+
+constexpr auto GUIDReferences = [] {
+  std::array<GUIDReference, std::size(GUIDReferenceTags)> refs{};
+  for (size_t i = 0; i < refs.size(); ++i) {
+    refs[i] = {toGUID(GUIDReferenceTags[i].voc_), asfObject(GUIDReferenceTags[i].label_)};
+  }
+  return refs;
+}();
+
+// Header object, see isASFType()
+static_assert(GUIDReferences[0].guid_[0] == 0x30 && GUIDReferences[0].guid_[5] == 0x66 &&
+              GUIDReferences[0].guid_[7] == 0x11 && GUIDReferences[0].guid_[8] == 0xa6 &&
+              GUIDReferences[0].guid_[15] == 0x6c && GUIDReferences[0].object_ == AsfObject::Header);
+
+//! Look up the GUID at buf, returns nullptr if it is unknown
+const GUIDReference* findGUID(const byte* buf) {
+  auto ref = std::find_if(GUIDReferences.begin(), GUIDReferences.end(),
+                          [buf](const GUIDReference& r) { return std::equal(r.guid_.begin(), r.guid_.end(), buf); });
+  return ref == GUIDReferences.end() ? nullptr : &*ref;
+}
+
 constexpr const TagDetails filePropertiesTags[] = {{7, "Xmp.video.FileLength"},   {6, "Xmp.video.CreationDate"},
                                                    {5, "Xmp.video.DataPackets"},  {4, "Xmp.video.Duration"},
                                                    {3, "Xmp.video.SendDuration"}, {2, "Xmp.video.Preroll"},
@@ -159,23 +256,6 @@ constexpr const TagDetails contentDescriptionTags[] = {{0, "Xmp.video.Title"},
                                                        {3, "Xmp.video.Description"},
                                                        {4, "Xmp.video.Rating"}};
 
-/*!
-  @brief Function used to check equality of two Tags (ignores case).
-  @param str1 char* Pointer to First TagVocabulary
-  @param str2 char* Pointer to Second TagVocabulary
-  @return Returns true if both are equal.
- */
-bool compareTag(const char* str1, const char* str2) {
-  if (strlen(str1) != strlen(str2))
-    return false;
-
-  for (uint64_t i = 0; i < strlen(str1); ++i)
-    if (tolower(str1[i]) != tolower(str2[i]))
-      return false;
-
-  return true;
-}
-
 /*!
   @brief Function used to calculate GUID, Tags comprises of 16 bytes.
       The Buffer contains the TagVocabulary in Binary Form. The information is then
@@ -225,7 +305,7 @@ namespace Exiv2 {
 
 using namespace Exiv2::Internal;
 
-AsfVideo::AsfVideo(BasicIo::UniquePtr io) : Image(ImageType::asf, mdNone, std::move(io)) {
+AsfVideo::AsfVideo(BasicIo::UniquePtr io) : Image(ImageType::asf, mdNone, std::move(io)), xmp_(xmpData_) {
 }  // AsfVideo::AsfVideo
 
 std::string AsfVideo::mimeType() const {
@@ -236,6 +316,7 @@ void AsfVideo::writeMetadata() {
 }
 
 void AsfVideo::readMetadata() {
+  EXV_STATS_SCOPE("AsfVideo::readMetadata");
   if (io_->open() != 0)
     throw Error(ErrorCode::kerDataSourceOpenFailed, io_->path(), strError());
 
@@ -248,13 +329,17 @@ void AsfVideo::readMetadata() {
 
   IoCloser closer(*io_);
   clearMetadata();
+  XmpDataFinisher finisher(xmp_);
   continueTraversing_ = true;
   io_->seek(0, BasicIo::beg);
   height_ = width_ = 1;
+  localPosition_ = 0;
+  streamNumber_ = 0;
+  previousStream_ = 0;
 
-  xmpData()["Xmp.video.FileSize"] = io_->size() / 1048576.;
-  xmpData()["Xmp.video.FileName"] = io_->path();
-  xmpData()["Xmp.video.MimeType"] = mimeType();
+  xmp_["Xmp.video.FileSize"] = io_->size() / 1048576.;
+  xmp_["Xmp.video.FileName"] = io_->path();
+  xmp_["Xmp.video.MimeType"] = mimeType();
 
   while (continueTraversing_)
     decodeBlock();
@@ -265,7 +350,6 @@ void AsfVideo::readMetadata() {
 void AsfVideo::decodeBlock() {
   DataBuf buf(BUFF_MIN_SIZE + 1);
   uint64_t size = 0;
-  const Internal::TagVocabulary* tv;
   uint64_t cur_pos = io_->tell();
 
   byte guidBuf[GUI_SIZE];
@@ -276,80 +360,77 @@ void AsfVideo::decodeBlock() {
     return;
   }
 
-  char GUID[GUID_SIZE] = "";  // the getGUID function write the GUID[36],
-
-  getGUID(guidBuf, GUID);
-  tv = find(GUIDReferenceTags, GUID);
+  const GUIDReference* ref = findGUID(guidBuf);
 
   io_->read(buf.data(), BUFF_MIN_SIZE);
   size = Util::getUint64_t(buf);
 
-  if (tv) {
-    auto tagDecoder = [&](const Internal::TagVocabulary* tv, uint64_t size) {
-      uint64_t cur_pos = io_->tell();
-      DataBuf buf(1000);
+  if (ref) {
+    auto tagDecoder = [&](AsfObject object, uint64_t objectSize) {
+      uint64_t objectStart = io_->tell();
+      DataBuf objectBuf(1000);
       unsigned long count = 0, tempLength = 0;
       Exiv2::Value::UniquePtr v = Exiv2::Value::create(Exiv2::xmpSeq);
 
-      if (compareTag(exvGettext(tv->label_), "Header")) {
+      if (object == AsfObject::Header) {
         localPosition_ = 0;
-        io_->read(buf.data(), 4);
-        io_->read(buf.data(), 2);
+        io_->read(objectBuf.data(), 4);
+        io_->read(objectBuf.data(), 2);
 
-        while (localPosition_ < cur_pos + size)
+        while (localPosition_ < objectStart + objectSize)
           decodeBlock();
       }
 
-      else if (compareTag(exvGettext(tv->label_), "File_Properties"))
+      else if (object == AsfObject::FileProperties)
         fileProperties();
 
-      else if (compareTag(exvGettext(tv->label_), "Stream_Properties"))
+      else if (object == AsfObject::StreamProperties)
         streamProperties();
 
-      else if (compareTag(exvGettext(tv->label_), "Metadata"))
+      else if (object == AsfObject::Metadata)
         metadataHandler(1);
 
-      else if (compareTag(exvGettext(tv->label_), "Extended_Content_Description"))
+      else if (object == AsfObject::ExtendedContentDescription)
         metadataHandler(2);
 
-      else if (compareTag(exvGettext(tv->label_), "Metadata_Library"))
+      else if (object == AsfObject::MetadataLibrary)
         metadataHandler(3);
 
-      else if (compareTag(exvGettext(tv->label_), "Codec_List"))
+      else if (object == AsfObject::CodecList)
         codecList();
 
-      else if (compareTag(exvGettext(tv->label_), "Content_Description"))
-        contentDescription(size);
+      else if (object == AsfObject::ContentDescription)
+        contentDescription(objectSize);
 
-      else if (compareTag(exvGettext(tv->label_), "Extended_Stream_Properties"))
-        extendedStreamProperties(size);
+      else if (object == AsfObject::ExtendedStreamProperties)
+        extendedStreamProperties(objectSize);
 
-      else if (compareTag(exvGettext(tv->label_), "Header_Extension")) {
+      else if (object == AsfObject::HeaderExtension) {
         localPosition_ = 0;
-        headerExtension(size);
+        headerExtension(objectSize);
       }
 
-      else if (compareTag(exvGettext(tv->label_), "Language_List")) {
-        std::memset(buf.data(), 0x0, buf.size());
-        io_->read(buf.data(), 2);
-        count = Exiv2::getUShort(buf.data(), littleEndian);
+      else if (object == AsfObject::LanguageList) {
+        std::memset(objectBuf.data(), 0x0, objectBuf.size());
+        io_->read(objectBuf.data(), 2);
+        count = Exiv2::getUShort(objectBuf.data(), littleEndian);
 
         while (count--) {
-          std::memset(buf.data(), 0x0, buf.size());
-          io_->read(buf.data(), 1);
-          tempLength = static_cast<int>(buf.data()[0]);
+          std::memset(objectBuf.data(), 0x0, objectBuf.size());
+          io_->read(objectBuf.data(), 1);
+          tempLength = static_cast<int>(objectBuf.data()[0]);
 
-          io_->read(buf.data(), tempLength);
-          v->read(Util::toString16(buf));
+          io_->read(objectBuf.data(), tempLength);
+          v->read(Util::toString16(objectBuf));
         }
         xmpData().add(Exiv2::XmpKey("Xmp.video.TrackLang"), v.get());
       }
 
-      io_->seek(cur_pos + size, BasicIo::beg);
+      io_->seek(objectStart + objectSize, BasicIo::beg);
       localPosition_ = io_->tell();
     };  // AsfVideo::tagDecoder
 
-    tagDecoder(tv, size - 24);
+    tagDecoder(ref->object_, size - 24);
   } else
     io_->seek(cur_pos + size, BasicIo::beg);
 
@@ -359,7 +440,6 @@ void AsfVideo::decodeBlock() {
 void AsfVideo::extendedStreamProperties(uint64_t size) {
   uint64_t cur_pos = io_->tell(), avgTimePerFrame = 0;
   DataBuf buf(BUFF_MIN_SIZE);
-  static int previousStream;
   io_->seek(cur_pos + 48, BasicIo::beg);
 
   io_->read(buf.data(), 2);
@@ -369,10 +449,10 @@ void AsfVideo::extendedStreamProperties(uint64_t size) {
   io_->read(buf.data(), BUFF_MIN_SIZE);
   avgTimePerFrame = Util::getUint64_t(buf);
 
-  if (previousStream < streamNumber_ && avgTimePerFrame != 0)
-    xmpData()["Xmp.video.FrameRate"] = 10000000. / avgTimePerFrame;
+  if (previousStream_ < streamNumber_ && avgTimePerFrame != 0)
+    xmp_["Xmp.video.FrameRate"] = 10000000. / avgTimePerFrame;
 
-  previousStream = streamNumber_;
+  previousStream_ = streamNumber_;
   io_->seek(cur_pos + size, BasicIo::beg);
 }  // AsfVideo::extendedStreamProperties
 
@@ -396,9 +476,9 @@ void AsfVideo::contentDescription(uint64_t size) {
     assert(td);
     std::string str(reinterpret_cast<const char*>(buf.data()), length[i]);
     if (convertStringCharset(str, "UCS-2LE", "UTF-8")) {
-      xmpData()[td->label_] = str;
+      xmp_[td->label_] = str;
     } else {
-      xmpData()[td->label_] = Util::toString16(buf);
+      xmp_[td->label_] = Util::toString16(buf);
     }
   }
   if (io_->seek(pos + size, BasicIo::beg))
@@ -411,23 +491,19 @@ void AsfVideo::streamProperties() {
   int stream = 0;
   enum streamTypeInfo { Audio = 1, Video = 2 };
   io_->read(guidBuf, GUI_SIZE);
-  char streamType[GUID_SIZE] = "";
-
-  getGUID(guidBuf, streamType);
-  const TagVocabulary* tv;
-  tv = find(GUIDReferenceTags, streamType);
+  const GUIDReference* ref = findGUID(guidBuf);
   io_->read(guidBuf, GUI_SIZE);
 
-  if (compareTag(exvGettext(tv->label_), "Audio_Media"))
+  if (ref && ref->object_ == AsfObject::AudioMedia)
     stream = Audio;
-  else if (compareTag(exvGettext(tv->label_), "Video_Media"))
+  else if (ref && ref->object_ == AsfObject::VideoMedia)
     stream = Video;
 
   io_->read(buf.data(), BUFF_MIN_SIZE);
   if (stream == Video)
-    xmpData()["Xmp.video.TimeOffset"] = Util::getUint64_t(buf);
+    xmp_["Xmp.video.TimeOffset"] = Util::getUint64_t(buf);
   else if (stream == Audio)
-    xmpData()["Xmp.audio.TimeOffset"] = Util::getUint64_t(buf);
+    xmp_["Xmp.audio.TimeOffset"] = Util::getUint64_t(buf);
 
   io_->read(buf.data(), BUFF_MIN_SIZE);
   std::memset(buf.data(), 0x0, buf.size());
@@ -440,25 +516,25 @@ void AsfVideo::streamProperties() {
   size_t temp = Exiv2::getUShort(buf.data(), littleEndian);
 
   if (stream == 2) {
-    xmpData()["Xmp.video.Width"] = temp;
+    xmp_["Xmp.video.Width"] = temp;
     width_ = temp;
   } else if (stream == Audio) {
-    // todo xmpData()["Xmp.audio.Codec"]
+    // todo xmp_["Xmp.audio.Codec"]
   }
 
   io_->read(buf.data(), 2);
   temp = Exiv2::getUShort(buf.data(), littleEndian);
   if (stream == Audio)
-    xmpData()["Xmp.audio.ChannelType"] = temp;
+    xmp_["Xmp.audio.ChannelType"] = temp;
 
   io_->read(buf.data(), 4);
   temp = Exiv2::getULong(buf.data(), littleEndian);
 
   if (stream == Video) {
-    xmpData()["Xmp.video.Height"] = temp;
+    xmp_["Xmp.video.Height"] = temp;
     height_ = temp;
   } else if (stream == Audio) {
-    xmpData()["Xmp.audio.SampleRate"] = temp;
+    xmp_["Xmp.audio.SampleRate"] = temp;
   }
 }  // AsfVideo::streamProperties
 
@@ -479,9 +555,9 @@ void AsfVideo::codecList() {
 
     io_->read(buf.data(), descLength);
     if (codecType == 1)
-      xmpData()["Xmp.video.Codec"] = Util::toString16(buf);
+      xmp_["Xmp.video.Codec"] = Util::toString16(buf);
     else if (codecType == 2)
-      xmpData()["Xmp.audio.Compressor"] = Util::toString16(buf);
+      xmp_["Xmp.audio.Compressor"] = Util::toString16(buf);
 
     std::memset(buf.data(), 0x0, buf.size());
     io_->read(buf.data(), 2);
@@ -490,9 +566,9 @@ void AsfVideo::codecList() {
     io_->read(buf.data(), descLength);
 
     if (codecType == 1)
-      xmpData()["Xmp.video.CodecDescription"] = Util::toString16(buf);
+      xmp_["Xmp.video.CodecDescription"] = Util::toString16(buf);
     else if (codecType == 2)
-      xmpData()["Xmp.audio.CodecDescription"] = Util::toString16(buf);
+      xmp_["Xmp.audio.CodecDescription"] = Util::toString16(buf);
 
     std::memset(buf.data(), 0x0, buf.size());
     io_->read(buf.data(), 2);
@@ -627,7 +703,7 @@ void AsfVideo::fileProperties() {
   char fileID[GUID_SIZE] = "";
   int count = 7;
   getGUID(guidBuf, fileID);
-  xmpData()["Xmp.video.FileID"] = fileID;
+  xmp_["Xmp.video.FileID"] = fileID;
 
   const TagDetails* td;
 
@@ -642,9 +718,9 @@ void AsfVideo::fileProperties() {
     }
 
     if (count == 3 || count == 2) {
-      xmpData()[exvGettext(td->label_)] = Util::getUint64_t(buf) / 10000;
+      xmp_[exvGettext(td->label_)] = Util::getUint64_t(buf) / 10000;
     } else {
-      xmpData()[exvGettext(td->label_)] = Util::getUint64_t(buf);
+      xmp_[exvGettext(td->label_)] = Util::getUint64_t(buf);
     }
   }
 }  // AsfVideo::fileProperties
@@ -654,34 +730,34 @@ void AsfVideo::aspectRatio() {
 
   double aspectRatio = static_cast<double>(width_) / height_;
   aspectRatio = floor(aspectRatio * 10) / 10;
-  xmpData()["Xmp.video.AspectRatio"] = aspectRatio;
+  xmp_["Xmp.video.AspectRatio"] = aspectRatio;
 
   auto aR = static_cast<int>((aspectRatio * 10.0) + 0.1);
 
   switch (aR) {
     case 13:
-      xmpData()["Xmp.video.AspectRatio"] = "4:3";
+      xmp_["Xmp.video.AspectRatio"] = "4:3";
       break;
     case 17:
-      xmpData()["Xmp.video.AspectRatio"] = "16:9";
+      xmp_["Xmp.video.AspectRatio"] = "16:9";
       break;
     case 10:
-      xmpData()["Xmp.video.AspectRatio"] = "1:1";
+      xmp_["Xmp.video.AspectRatio"] = "1:1";
       break;
     case 16:
-      xmpData()["Xmp.video.AspectRatio"] = "16:10";
+      xmp_["Xmp.video.AspectRatio"] = "16:10";
       break;
     case 22:
-      xmpData()["Xmp.video.AspectRatio"] = "2.21:1";
+      xmp_["Xmp.video.AspectRatio"] = "2.21:1";
       break;
     case 23:
-      xmpData()["Xmp.video.AspectRatio"] = "2.35:1";
+      xmp_["Xmp.video.AspectRatio"] = "2.35:1";
       break;
     case 12:
-      xmpData()["Xmp.video.AspectRatio"] = "5:4";
+      xmp_["Xmp.video.AspectRatio"] = "5:4";
       break;
     default:
-      xmpData()["Xmp.video.AspectRatio"] = aspectRatio;
+      xmp_["Xmp.video.AspectRatio"] = aspectRatio;
       break;
   }
 }  // AsfVideo::aspectRatio
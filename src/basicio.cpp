@@ -9,12 +9,14 @@
 #include "futils.hpp"
 #include "http.hpp"
 #include "image_int.hpp"
+#include "stats_int.hpp"
 #include "types.hpp"
 
 // + standard includes
 #include <fcntl.h>     // _O_BINARY in FileIo::FileIo
 #include <sys/stat.h>  // for stat, chmod
 
+#include <algorithm>
 #include <cstdio>   // for remove, rename
 #include <cstdlib>  // for alloc, realloc, free
 #include <cstring>  // std::memcpy
@@ -22,6 +24,7 @@
 #include <filesystem>
 #include <fstream>  // write the temporary file
 #include <iostream>
+#include <limits>
 
 #ifdef EXV_HAVE_SYS_MMAN_H
 #include <sys/mman.h>  // for mmap and munmap
@@ -32,6 +35,9 @@
 #ifdef EXV_HAVE_UNISTD_H
 #include <unistd.h>  // for getpid, stat
 #endif
+#ifdef EXV_HAVE_SYS_XATTR_H
+#include <sys/xattr.h>  // for listxattr, getxattr, fsetxattr
+#endif
 
 #ifdef EXV_USE_CURL
 #include <curl/curl.h>
@@ -56,6 +62,91 @@ void ReplaceStringInPlace(std::string& subject, std::string_view search, std::st
     pos += subject.find(search, pos + replace.length());
   }
 }
+
+#ifndef _WIN32
+/*!
+  @brief Return true if \em path can be replaced by renaming another file over it
+         without changing what is seen through other links to it or who owns it.
+ */
+bool canReplaceByRename(const std::string& path) {
+  std::error_code ec;
+  const auto status = fs::symlink_status(path, ec);
+  if (ec || status.type() != fs::file_type::regular)
+    return false;
+  struct stat st;
+  if (::stat(path.c_str(), &st) != 0)
+    return false;
+  return st.st_nlink == 1 && st.st_uid == ::geteuid();
+}
+
+#ifdef EXV_HAVE_SYS_XATTR_H
+/*!
+  @brief Copy the extended attributes of \em path, which include ACLs and
+         security labels, to the open file \em fd.
+  @return false if an attribute cannot be copied
+ */
+bool copyXattrs(const std::string& path, int fd) {
+#ifdef __APPLE__
+  const auto list = [&](char* names, size_t size) { return ::listxattr(path.c_str(), names, size, XATTR_NOFOLLOW); };
+  const auto get = [&](const char* name, void* value, size_t size) {
+    return ::getxattr(path.c_str(), name, value, size, 0, XATTR_NOFOLLOW);
+  };
+  const auto set = [&](const char* name, const void* value, size_t size) {
+    return ::fsetxattr(fd, name, value, size, 0, 0);
+  };
+#else
+  const auto list = [&](char* names, size_t size) { return ::llistxattr(path.c_str(), names, size); };
+  const auto get = [&](const char* name, void* value, size_t size) {
+    return ::lgetxattr(path.c_str(), name, value, size);
+  };
+  const auto set = [&](const char* name, const void* value, size_t size) {
+    return ::fsetxattr(fd, name, value, size, 0);
+  };
+#endif
+  const auto namesSize = list(nullptr, 0);
+  if (namesSize < 0)
+    return errno == ENOTSUP;  // the file system has no extended attributes
+  std::vector<char> names(namesSize);
+  if (list(names.data(), names.size()) != namesSize)
+    return false;
+  for (size_t i = 0; i < names.size(); i += std::strlen(&names[i]) + 1) {
+    const char* name = &names[i];
+    const auto valueSize = get(name, nullptr, 0);
+    if (valueSize < 0)
+      return false;
+    std::vector<char> value(valueSize);
+    if (get(name, value.data(), value.size()) != valueSize || set(name, value.data(), value.size()) != 0)
+      return false;
+  }
+  return true;
+}
+#endif  // EXV_HAVE_SYS_XATTR_H
+
+/*!
+  @brief Give the open file \em fd the owner, group, permissions, extended
+         attributes and access time of \em path, described by \em st. The
+         modification time is set to now, as if \em path had been rewritten.
+  @return false if any of them cannot be copied
+ */
+bool copyFileAttributes(const std::string& path, const struct stat& st, int fd) {
+  // chown() may clear the set-user-ID and set-group-ID bits, so set the mode afterwards
+  if (::fchown(fd, st.st_uid, st.st_gid) != 0 || ::fchmod(fd, st.st_mode & 07777) != 0)
+    return false;
+#ifdef EXV_HAVE_SYS_XATTR_H
+  if (!copyXattrs(path, fd))
+    return false;
+#endif
+  struct timespec times[2];
+#ifdef __APPLE__
+  times[0] = st.st_atimespec;
+#else
+  times[0] = st.st_atim;
+#endif
+  times[1].tv_sec = 0;
+  times[1].tv_nsec = UTIME_NOW;
+  return ::futimens(fd, times) == 0;
+}
+#endif  // _WIN32
 }  // namespace
 
 namespace Exiv2 {
@@ -174,7 +265,14 @@ int FileIo::Impl::switchMode(OpMode opMode) {
 int FileIo::Impl::stat(StructStat& buf) const {
   int ret = 0;
   struct stat st;
-  ret = ::stat(path_.c_str(), &st);
+#ifndef _WIN32
+  // Parsers query the size for many reads, avoid resolving the path again
+  // while the file is open
+  if (fp_)
+    ret = ::fstat(fileno(fp_), &st);
+  else
+#endif
+    ret = ::stat(path_.c_str(), &st);
   if (0 == ret) {
     buf.st_size = st.st_size;
     buf.st_mode = st.st_mode;
@@ -304,7 +402,10 @@ void FileIo::setPath(const std::string& path) {
 size_t FileIo::write(const byte* data, size_t wcount) {
   if (p_->switchMode(Impl::opWrite) != 0)
     return 0;
-  return std::fwrite(data, 1, wcount, p_->fp_);
+  const size_t writeCount = std::fwrite(data, 1, wcount, p_->fp_);
+  EXV_STATS_COUNT(writes_, 1);
+  EXV_STATS_COUNT(bytesWritten_, writeCount);
+  return writeCount;
 }
 
 size_t FileIo::write(BasicIo& src) {
@@ -315,11 +416,26 @@ size_t FileIo::write(BasicIo& src) {
   if (p_->switchMode(Impl::opWrite) != 0)
     return 0;
 
-  byte buf[4096];
+  // Optimization if src is an instance of MemIo: write its remaining data in one go
+  if (auto memIo = dynamic_cast<MemIo*>(&src)) {
+    const size_t pos = memIo->tell();
+    const size_t srcSize = memIo->size();
+    if (pos >= srcSize)
+      return 0;
+    const size_t writeTotal = std::fwrite(memIo->mmap() + pos, 1, srcSize - pos, p_->fp_);
+    EXV_STATS_COUNT(writes_, 1);
+    EXV_STATS_COUNT(bytesWritten_, writeTotal);
+    memIo->seek(static_cast<int64_t>(writeTotal), BasicIo::cur);
+    return writeTotal;
+  }
+
+  DataBuf buf(64 * 1024);
   size_t readCount = 0;
   size_t writeTotal = 0;
-  while ((readCount = src.read(buf, sizeof(buf)))) {
-    size_t writeCount = std::fwrite(buf, 1, readCount, p_->fp_);
+  while ((readCount = src.read(buf.data(), buf.size()))) {
+    size_t writeCount = std::fwrite(buf.c_data(), 1, readCount, p_->fp_);
+    EXV_STATS_COUNT(writes_, 1);
+    EXV_STATS_COUNT(bytesWritten_, writeCount);
     writeTotal += writeCount;
     if (writeCount != readCount) {
       // try to reset back to where write stopped
@@ -388,11 +504,8 @@ void FileIo::transfer(BasicIo& src) {
         }
       }
 #else
-      if (fileExists(pf) && fs::remove(pf) != 0) {
-        throw Error(ErrorCode::kerCallFailed, pf, strError(), "fs::remove");
-      }
+      // rename() atomically replaces an existing file
       fs::rename(fileIo->path(), pf);
-      fs::remove(fileIo->path());
 #endif
       // Check permissions of new file
       struct stat buf2;
@@ -410,7 +523,9 @@ void FileIo::transfer(BasicIo& src) {
       }
     }
   }  // if (fileIo)
-  else {
+  else if (stageAndReplace(src)) {
+    // The data was written to a temporary file, which replaced this file
+  } else {
     // Generic handling, reopen both to reset to start
     if (open("w+b") != 0) {
       throw Error(ErrorCode::kerFileOpenFailed, path(), "w+b", strError());
@@ -434,6 +549,68 @@ void FileIo::transfer(BasicIo& src) {
   }
 }  // FileIo::transfer
 
+bool FileIo::stageAndReplace(BasicIo& src) {
+#ifdef _WIN32
+  (void)src;
+  return false;
+#else
+  // A new file is simply created, there is nothing to protect
+  struct stat st;
+  if (::stat(path().c_str(), &st) != 0 || !canReplaceByRename(path()))
+    return false;
+
+  // mkstemp() creates a new file with a unique name and does not follow symbolic links
+  std::string tempPath = path() + ".exiv2-XXXXXX";
+  const int fd = ::mkstemp(tempPath.data());
+  if (fd == -1)
+    return false;
+  const auto discard = [&] {
+    ::close(fd);
+    ::unlink(tempPath.c_str());
+  };
+
+  try {
+    if (src.open() != 0)
+      throw Error(ErrorCode::kerDataSourceOpenFailed, src.path(), strError());
+    const size_t srcSize = src.size();
+    size_t writeTotal = 0;
+    DataBuf buf(64 * 1024);
+    while (size_t readCount = src.read(buf.data(), buf.size())) {
+      const ssize_t writeCount = ::write(fd, buf.c_data(), readCount);
+      EXV_STATS_COUNT(writes_, 1);
+      EXV_STATS_COUNT(bytesWritten_, writeCount > 0 ? static_cast<size_t>(writeCount) : 0);
+      if (writeCount != static_cast<ssize_t>(readCount))
+        break;
+      writeTotal += readCount;
+    }
+    src.close();
+    if (writeTotal != srcSize || src.error())
+      throw Error(ErrorCode::kerTransferFailed, path(), strError());
+  } catch (...) {
+    discard();
+    throw;
+  }
+
+  // Copy the attributes last, writing may clear the set-user-ID bit
+  if (!copyFileAttributes(path(), st, fd)) {
+    discard();
+    return false;  // write in place, which keeps everything the copy would lose
+  }
+  // Make sure the data is on disk before the file replaces the original
+  if (::fsync(fd) != 0) {
+    discard();
+    throw Error(ErrorCode::kerTransferFailed, path(), strError());
+  }
+  ::close(fd);
+  if (::rename(tempPath.c_str(), path().c_str()) != 0) {
+    const std::string error = strError();
+    ::unlink(tempPath.c_str());
+    throw Error(ErrorCode::kerFileRenameFailed, tempPath, path(), error);
+  }
+  return true;
+#endif
+}
+
 int FileIo::putb(byte data) {
   if (p_->switchMode(Impl::opWrite) != 0)
     return EOF;
@@ -441,6 +618,7 @@ int FileIo::putb(byte data) {
 }
 
 int FileIo::seek(int64_t offset, Position pos) {
+  EXV_STATS_COUNT(seeks_, 1);
   int fileSeek = 0;
   switch (pos) {
     case BasicIo::cur:
@@ -534,7 +712,10 @@ size_t FileIo::read(byte* buf, size_t rcount) {
   if (p_->switchMode(Impl::opRead) != 0) {
     return 0;
   }
-  return std::fread(buf, 1, rcount, p_->fp_);
+  const size_t readCount = std::fread(buf, 1, rcount, p_->fp_);
+  EXV_STATS_COUNT(reads_, 1);
+  EXV_STATS_COUNT(bytesRead_, readCount);
+  return readCount;
 }
 
 int FileIo::getb() {
@@ -698,6 +879,8 @@ MemIo::~MemIo() {
 }
 
 size_t MemIo::write(const byte* data, size_t wcount) {
+  EXV_STATS_COUNT(writes_, 1);
+  EXV_STATS_COUNT(bytesWritten_, wcount);
   p_->reserve(wcount);
   if (data) {
     std::memcpy(&p_->data_[p_->idx_], data, wcount);
@@ -740,9 +923,25 @@ size_t MemIo::write(BasicIo& src) {
   if (!src.isopen())
     return 0;
 
+  // Read the remaining data of the source straight into the memory area
+  size_t writeTotal = 0;
+  const size_t srcSize = src.size();
+  const size_t srcPos = src.tell();
+  if (srcSize != std::numeric_limits<size_t>::max() && srcSize > srcPos) {
+    const size_t oldSize = p_->size_;
+    const size_t wcount = srcSize - srcPos;
+    p_->reserve(wcount);
+    writeTotal = src.read(&p_->data_[p_->idx_], wcount);
+    EXV_STATS_COUNT(writes_, 1);
+    EXV_STATS_COUNT(bytesWritten_, writeTotal);
+    p_->idx_ += writeTotal;
+    if (writeTotal < wcount)
+      p_->size_ = std::max(oldSize, p_->idx_);
+  }
+
+  // Copy anything beyond the size reported by the source
   byte buf[4096];
   size_t readCount = 0;
-  size_t writeTotal = 0;
   while ((readCount = src.read(buf, sizeof(buf)))) {
     write(buf, readCount);
     writeTotal += readCount;
@@ -758,6 +957,7 @@ int MemIo::putb(byte data) {
 }
 
 int MemIo::seek(int64_t offset, Position pos) {
+  EXV_STATS_COUNT(seeks_, 1);
   int64_t newIdx = 0;
 
   switch (pos) {
@@ -832,6 +1032,8 @@ size_t MemIo::read(byte* buf, size_t rcount) {
   if (rcount > avail) {
     p_->eof_ = true;
   }
+  EXV_STATS_COUNT(reads_, 1);
+  EXV_STATS_COUNT(bytesRead_, allow);
   return allow;
 }
 
@@ -11,6 +11,7 @@
 #include "image.hpp"
 #include "image_int.hpp"
 #include "safe_op.hpp"
+#include "stats_int.hpp"
 #include "tiffimage.hpp"
 #include "tiffimage_int.hpp"
 #include "types.hpp"
@@ -20,6 +21,8 @@
 #endif
 
 // + standard includes
+#include <algorithm>
+#include <atomic>
 #include <cinttypes>
 #include <cstdio>
 #include <cstring>
@@ -65,7 +68,7 @@
 // class member definitions
 #ifdef EXV_ENABLE_BMFF
 namespace Exiv2 {
-static bool enabled = false;
+static std::atomic<bool> enabled = false;
 EXIV2API bool enableBMFF(bool enable) {
   enabled = enable;
   return true;
@@ -111,6 +114,14 @@ static bool skipBox(uint32_t box) {
   return box == TAG_mdat;  // mdat is where the main image lives and can be huge
 }
 
+static bool readsBoxData(uint32_t box) {
+  // Box types whose case in boxHandler() parses the box contents from memory.
+  // All other boxes are containers, are parsed directly from io_ or are
+  // ignored, so their (possibly large) payload is not read into memory.
+  return box == TAG_ftyp || box == TAG_iinf || box == TAG_infe || box == TAG_iloc || box == TAG_ispe ||
+         box == TAG_colr || box == TAG_brob || box == TAG_thmb || box == TAG_prvw;
+}
+
 std::string BmffImage::mimeType() const {
   switch (fileType_) {
     case TAG_avif:
@@ -186,58 +197,59 @@ class BrotliDecoderWrapper {
   }
 };
 
-void BmffImage::brotliUncompress(const byte* compressedBuf, size_t compressedBufSize, DataBuf& arr) {
+void BmffImage::brotliUncompress(const byte* compressedBuf, size_t compressedBufSize, DataBuf& arr,
+                                 size_t maxSize) {
   BrotliDecoderWrapper decoder;
-  size_t uncompressedLen = compressedBufSize * 2;  // just a starting point
-  BrotliDecoderResult result;
-  int dos = 0;
   size_t available_in = compressedBufSize;
   const byte* next_in = compressedBuf;
-  size_t available_out;
-  byte* next_out;
   size_t total_out = 0;
 
-  do {
-    arr.alloc(uncompressedLen);
-    available_out = uncompressedLen - total_out;
-    next_out = arr.data() + total_out;
+  // Let the decoder fill the buffer in place and grow it geometrically
+  // up to maxSize, so the output is never copied between attempts.
+  arr.alloc(std::min(std::max<size_t>(compressedBufSize * 2, 4096), maxSize));
+  BrotliDecoderResult result;
+  for (;;) {
+    size_t available_out = arr.size() - total_out;
+    byte* next_out = arr.data() + total_out;
     result =
         BrotliDecoderDecompressStream(decoder.get(), &available_in, &next_in, &available_out, &next_out, &total_out);
-    if (result == BROTLI_DECODER_RESULT_SUCCESS) {
-      arr.resize(total_out);
-    } else if (result == BROTLI_DECODER_RESULT_NEEDS_MORE_OUTPUT) {
-      uncompressedLen *= 2;
-      // DoS protection - can't be bigger than 128k
-      if (uncompressedLen > 131072) {
-        if (++dos > 1)
-          break;
-        uncompressedLen = 131072;
-      }
-    } else if (result == BROTLI_DECODER_RESULT_NEEDS_MORE_INPUT) {
-      // compressed input buffer in incomplete
+    if (result != BROTLI_DECODER_RESULT_NEEDS_MORE_OUTPUT)
+      break;
+    // DoS protection - the uncompressed data must not exceed maxSize
+    if (arr.size() >= maxSize) {
+#ifndef SUPPRESS_WARNINGS
+      EXV_WARNING << "Brotli compressed box expands to more than " << maxSize << " bytes\n";
+#endif
       throw Error(ErrorCode::kerFailedToReadImageData);
-    } else {
-      // something bad happened
-      throw Error(ErrorCode::kerErrorMessage, BrotliDecoderErrorString(BrotliDecoderGetErrorCode(decoder.get())));
     }
-  } while (result != BROTLI_DECODER_RESULT_SUCCESS);
+    arr.resize(std::min(arr.size() * 2, maxSize));
+  }
 
-  if (result != BROTLI_DECODER_RESULT_SUCCESS) {
+  if (result == BROTLI_DECODER_RESULT_NEEDS_MORE_INPUT) {
+    // compressed input buffer in incomplete
     throw Error(ErrorCode::kerFailedToReadImageData);
   }
+  if (result != BROTLI_DECODER_RESULT_SUCCESS) {
+    // something bad happened
+    throw Error(ErrorCode::kerErrorMessage, BrotliDecoderErrorString(BrotliDecoderGetErrorCode(decoder.get())));
+  }
+  arr.resize(total_out);
 }
 #endif
 
 uint64_t BmffImage::boxHandler(std::ostream& out /* = std::cout*/, Exiv2::PrintStructureOption option /* = kpsNone */,
                                uint64_t pbox_end, size_t depth) {
   const size_t address = io_->tell();
-  // never visit a box twice!
+  // never visit a box twice! Children start after their parent's header and
+  // siblings after the previous box, so a box that does not lie beyond the
+  // last one visited is a loop.
   if (depth == 0)
-    visits_.clear();
-  if (visits_.find(address) != visits_.end() || visits_.size() > visits_max_) {
+    visits_ = 0;
+  if ((visits_ != 0 && address <= lastVisit_) || visits_ > visits_max_) {
     throw Error(ErrorCode::kerCorruptedMetadata);
   }
-  visits_.insert(address);
+  lastVisit_ = address;
+  visits_++;
 
 #ifdef EXIV2_DEBUG_MESSAGES
   bool bTrace = true;
@@ -259,6 +271,15 @@ uint64_t BmffImage::boxHandler(std::ostream& out /* = std::cout*/, Exiv2::PrintS
   uint32_t box_type = getULong(reinterpret_cast<byte*>(&hdrbuf[sizeof(uint32_t)]), endian_);
   bool bLF = true;
 
+  // boxes elided by the print limits are skipped like the ones we never parse
+  const auto& limits = printStructureLimits();
+  const auto& skipTypes = limits.skipTypes_;
+  const bool bElide = (option == kpsBasic || option == kpsRecursive) &&
+                      (depth - printTop_ > limits.maxDepth_ ||
+                       std::find(skipTypes.begin(), skipTypes.end(), toAscii(box_type)) != skipTypes.end());
+  if (bElide)
+    bTrace = false;
+
   if (bTrace) {
     bLF = true;
     out << Internal::indent(depth) << "Exiv2::BmffImage::boxHandler: " << toAscii(box_type)
@@ -280,7 +301,7 @@ uint64_t BmffImage::boxHandler(std::ostream& out /* = std::cout*/, Exiv2::PrintS
   enforce(box_length - hdrsize <= pbox_end - restore, Exiv2::ErrorCode::kerCorruptedMetadata);
 
   const auto buffer_size = box_length - hdrsize;
-  if (skipBox(box_type)) {
+  if (skipBox(box_type) || bElide) {
     if (bTrace) {
       out << std::endl;
     }
@@ -289,8 +310,10 @@ uint64_t BmffImage::boxHandler(std::ostream& out /* = std::cout*/, Exiv2::PrintS
     return restore + buffer_size;
   }
 
-  DataBuf data(static_cast<size_t>(buffer_size));
-  const size_t box_end = restore + data.size();
+  // Containers and boxes parsed straight from io_ only need their version/flags
+  const size_t box_end = restore + static_cast<size_t>(buffer_size);
+  DataBuf data(readsBoxData(box_type) ? static_cast<size_t>(buffer_size)
+                                      : std::min<size_t>(fullBox(box_type) ? 4 : 0, buffer_size));
   io_->read(data.data(), data.size());
   io_->seek(restore, BasicIo::beg);
 
@@ -531,7 +554,7 @@ uint64_t BmffImage::boxHandler(std::ostream& out /* = std::cout*/, Exiv2::PrintS
       }
 #ifdef EXV_HAVE_BROTLI
       DataBuf arr;
-      brotliUncompress(data.c_data(4), data.size() - 4, arr);
+      brotliUncompress(data.c_data(4), data.size() - 4, arr, brotliMaxSize_);
       if (realType == TAG_exif) {
         uint32_t offset = Safe::add(arr.read_uint32(0, endian_), 4u);
         enforce(Safe::add(offset, 4u) < arr.size(), Exiv2::ErrorCode::kerCorruptedMetadata);
@@ -701,6 +724,7 @@ void BmffImage::openOrThrow() {
 }  // Bmff::openOrThrow();
 
 void BmffImage::readMetadata() {
+  EXV_STATS_SCOPE("BmffImage::readMetadata");
   openOrThrow();
   IoCloser closer(*io_);
 
@@ -720,6 +744,20 @@ void BmffImage::readMetadata() {
   bReadMetadata_ = true;
 }  // BmffImage::readMetadata
 
+void BmffImage::setBrotliMaxSize(size_t size) {
+  brotliMaxSize_ = size;
+}
+
+size_t BmffImage::brotliMaxSize() const {
+  return brotliMaxSize_;
+}
+
+void BmffImage::doReopen() {
+  fileType_ = 0;
+  ilocs_.clear();
+  bReadMetadata_ = false;
+}
+
 void BmffImage::printStructure(std::ostream& out, Exiv2::PrintStructureOption option, size_t depth) {
   if (!bReadMetadata_)
     readMetadata();
@@ -748,6 +786,8 @@ void BmffImage::printStructure(std::ostream& out, Exiv2::PrintStructureOption op
 
       uint64_t address = 0;
       const auto file_end = io_->size();
+      printTop_ = depth;
+      visits_ = 0;  // the loop guard only resets itself at depth 0
       while (address < file_end) {
         io_->seek(address, BasicIo::beg);
         address = boxHandler(out, option, file_end, depth);
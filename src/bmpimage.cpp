@@ -10,6 +10,7 @@
 #include "error.hpp"
 #include "futils.hpp"
 #include "image.hpp"
+#include "stats_int.hpp"
 
 // + standard includes
 #include <cstring>
@@ -40,6 +41,7 @@ void BmpImage::setComment(const std::string&) {
 }
 
 void BmpImage::readMetadata() {
+  EXV_STATS_SCOPE("BmpImage::readMetadata");
 #ifdef EXIV2_DEBUG_MESSAGES
   std::cerr << "Exiv2::BmpImage::readMetadata: Reading Windows bitmap file " << io_->path() << "\n";
 #endif
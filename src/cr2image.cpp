@@ -8,6 +8,7 @@
 #include "error.hpp"
 #include "futils.hpp"
 #include "image.hpp"
+#include "stats_int.hpp"
 #include "tiffcomposite_int.hpp"
 #include "tiffimage_int.hpp"
 
@@ -55,6 +56,7 @@ void Cr2Image::setComment(const std::string&) {
 }
 
 void Cr2Image::readMetadata() {
+  EXV_STATS_SCOPE("Cr2Image::readMetadata");
 #ifdef EXIV2_DEBUG_MESSAGES
   std::cerr << "Reading CR2 file " << io_->path() << "\n";
 #endif
@@ -74,6 +76,7 @@ void Cr2Image::readMetadata() {
 }  // Cr2Image::readMetadata
 
 void Cr2Image::writeMetadata() {
+  EXV_STATS_SCOPE("Cr2Image::writeMetadata");
 #ifdef EXIV2_DEBUG_MESSAGES
   std::cerr << "Writing CR2 file " << io_->path() << "\n";
 #endif
@@ -105,19 +108,8 @@ ByteOrder Cr2Parser::decode(ExifData& exifData, IptcData& iptcData, XmpData& xmp
 
 WriteMethod Cr2Parser::encode(BasicIo& io, const byte* pData, size_t size, ByteOrder byteOrder,
                               const ExifData& exifData, const IptcData& iptcData, const XmpData& xmpData) {
-  // Copy to be able to modify the Exif data
-  ExifData ed = exifData;
-
-  // Delete IFDs which do not occur in TIFF images
-  static constexpr auto filteredIfds = std::array{
-      IfdId::panaRawId,
-  };
-  for (auto&& filteredIfd : filteredIfds) {
-#ifdef EXIV2_DEBUG_MESSAGES
-    std::cerr << "Warning: Exif IFD " << filteredIfd << " not encoded\n";
-#endif
-    ed.erase(std::remove_if(ed.begin(), ed.end(), Internal::FindExifdatum(filteredIfd)), ed.end());
-  }
+  ExifData filtered;
+  const ExifData& ed = Internal::filterTiffExifData(exifData, filtered);
 
   auto header = Internal::Cr2Header(byteOrder);
   Internal::OffsetWriter offsetWriter;
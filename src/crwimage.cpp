@@ -11,6 +11,7 @@
 #include "crwimage_int.hpp"
 #include "error.hpp"
 #include "futils.hpp"
+#include "stats_int.hpp"
 #include "tags.hpp"
 
 #include <iostream>
@@ -48,6 +49,7 @@ void CrwImage::setIptcData(const IptcData& /*iptcData*/) {
 }
 
 void CrwImage::readMetadata() {
+  EXV_STATS_SCOPE("CrwImage::readMetadata");
 #ifdef EXIV2_DEBUG_MESSAGES
   std::cerr << "Reading CRW file " << io_->path() << "\n";
 #endif
@@ -70,6 +72,7 @@ void CrwImage::readMetadata() {
 }  // CrwImage::readMetadata
 
 void CrwImage::writeMetadata() {
+  EXV_STATS_SCOPE("CrwImage::writeMetadata");
 #ifdef EXIV2_DEBUG_MESSAGES
   std::cerr << "Writing CRW file " << io_->path() << "\n";
 #endif
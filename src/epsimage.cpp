@@ -16,6 +16,7 @@
 #include "error.hpp"
 #include "futils.hpp"
 #include "image.hpp"
+#include "stats_int.hpp"
 #include "utils.hpp"
 #include "version.hpp"
 
@@ -114,15 +115,22 @@ bool onlyWhitespaces(const std::string& s) {
   return s.find_first_not_of(" \t") == std::string::npos;
 }
 
+//! Check whether a byte ends a line (CR or LF)
+bool isLineEnding(byte b) {
+  return b == '\r' || b == '\n';
+}
+
+//! Check whether a byte may start an XMP header or trailer
+bool isXmpCandidate(byte b) {
+  return b == '\x00' || b == '<';
+}
+
 //! Read the next line of a buffer, allow for changing line ending style
 size_t readLine(std::string& line, const byte* data, size_t startPos, size_t size) {
-  line.clear();
-  size_t pos = startPos;
-  // step through line
-  while (pos < size && data[pos] != '\r' && data[pos] != '\n') {
-    line += data[pos];
-    pos++;
-  }
+  // find the end of the line and copy it in one go
+  const byte* end = std::find_if(data + startPos, data + size, isLineEnding);
+  line.assign(reinterpret_cast<const char*>(data + startPos), end - (data + startPos));
+  size_t pos = end - data;
   // skip line ending, if present
   if (pos >= size)
     return pos;
@@ -153,12 +161,11 @@ size_t readPrevLine(std::string& line, const byte* data, size_t startPos, size_t
         return pos;
     }
   }
-  // step through previous line
-  while (pos >= 1 && data[pos - 1] != '\r' && data[pos - 1] != '\n') {
+  // find the start of the previous line and copy it in one go
+  const size_t endPos = pos;
+  while (pos >= 1 && !isLineEnding(data[pos - 1]))
     pos--;
-    line += data[pos];
-  }
-  std::reverse(line.begin(), line.end());
+  line.assign(reinterpret_cast<const char*>(data + pos), endPos - pos);
   return pos;
 }
 
@@ -167,8 +174,9 @@ void findXmp(size_t& xmpPos, size_t& xmpSize, const byte* data, size_t startPos,
   // search for valid XMP header
   xmpSize = 0;
   for (xmpPos = startPos; xmpPos < size; xmpPos++) {
-    if (data[xmpPos] != '\x00' && data[xmpPos] != '<')
-      continue;
+    xmpPos = std::find_if(data + xmpPos, data + size, isXmpCandidate) - data;
+    if (xmpPos >= size)
+      break;
     for (auto&& header : xmpHeaders) {
       if (xmpPos + header.size() > size)
         continue;
@@ -180,8 +188,9 @@ void findXmp(size_t& xmpPos, size_t& xmpSize, const byte* data, size_t startPos,
 
       // search for valid XMP trailer
       for (size_t trailerPos = xmpPos + header.size(); trailerPos < size; trailerPos++) {
-        if (data[xmpPos] != '\x00' && data[xmpPos] != '<')
-          continue;
+        trailerPos = std::find_if(data + trailerPos, data + size, isXmpCandidate) - data;
+        if (trailerPos >= size)
+          break;
         for (const auto& [trailer, readOnly] : xmpTrailers) {
           if (trailerPos + trailer.size() > size)
             continue;
@@ -371,9 +380,9 @@ void readWriteEpsMetadata(BasicIo& io, std::string& xmpPacket, NativePreviewList
   bool inRemovableEmbedding = false;
   std::string removableEmbeddingEndLine;
   size_t removableEmbeddingsWithUnmarkedTrailer = 0;
+  std::string line;
   for (size_t pos = posEps; pos < posEof;) {
     const size_t startPos = pos;
-    std::string line;
     pos = readLine(line, data, startPos, posEndEps);
 #ifdef DEBUG
     bool significantLine = true;
@@ -626,7 +635,6 @@ void readWriteEpsMetadata(BasicIo& io, std::string& xmpPacket, NativePreviewList
   }
 
   // interpret comment "%ADO_ContainsXMP:"
-  std::string line;
   readLine(line, data, posContainsXmp, posEndEps);
   bool containsXmp;
   if (line == "%ADO_ContainsXMP: MainFirst" || line == "%ADO_ContainsXMP:MainFirst") {
@@ -1085,6 +1093,7 @@ void EpsImage::setComment(const std::string&) {
 }
 
 void EpsImage::readMetadata() {
+  EXV_STATS_SCOPE("EpsImage::readMetadata");
 #ifdef DEBUG
   EXV_DEBUG << "Exiv2::EpsImage::readMetadata: Reading EPS file " << io_->path() << "\n";
 #endif
@@ -1106,6 +1115,7 @@ void EpsImage::readMetadata() {
 }
 
 void EpsImage::writeMetadata() {
+  EXV_STATS_SCOPE("EpsImage::writeMetadata");
 #ifdef DEBUG
   EXV_DEBUG << "Exiv2::EpsImage::writeMetadata: Writing EPS file " << io_->path() << "\n";
 #endif
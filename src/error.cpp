@@ -99,15 +99,17 @@ static_assert(errList.size() == static_cast<size_t>(Exiv2::ErrorCode::kerErrorCo
 // *****************************************************************************
 // class member definitions
 namespace Exiv2 {
-LogMsg::Level LogMsg::level_ = LogMsg::warn;  // Default output level
-LogMsg::Handler LogMsg::handler_ = LogMsg::defaultHandler;
+std::atomic<LogMsg::Level> LogMsg::level_ = LogMsg::warn;  // Default output level
+std::atomic<LogMsg::Handler> LogMsg::handler_ = LogMsg::defaultHandler;
 
 LogMsg::LogMsg(LogMsg::Level msgType) : msgType_(msgType) {
 }
 
 LogMsg::~LogMsg() {
-  if (msgType_ >= level_ && handler_)
-    handler_(msgType_, os_.str().c_str());
+  // load the handler once, it may be replaced by another thread
+  const Handler logHandler = handler_;
+  if (msgType_ >= level_ && logHandler)
+    logHandler(msgType_, os_.str().c_str());
 }
 
 std::ostringstream& LogMsg::os() {
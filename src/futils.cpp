@@ -19,6 +19,10 @@
 #ifdef EXV_HAVE_UNISTD_H
 #include <unistd.h>  // for stat()
 #endif
+#ifdef EXV_HAVE_POSIX_FADVISE
+#include <fcntl.h>     // for open() and posix_fadvise()
+#include <sys/stat.h>  // for fstat()
+#endif
 
 namespace fs = std::filesystem;
 
@@ -222,6 +226,28 @@ bool fileExists(const std::string& path) {
   return fs::exists(path);
 }
 
+void prefetchFile(const std::string& path, size_t length) {
+#ifdef EXV_HAVE_POSIX_FADVISE
+  if (fileProtocol(path) != pFile) {
+    return;
+  }
+  // O_NONBLOCK: opening a FIFO or a device must not wait for the other end
+  const int fd = ::open(path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+  if (fd < 0) {
+    return;
+  }
+  // Starts asynchronous readahead, the page cache outlives the descriptor
+  struct stat st;
+  if (::fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+    ::posix_fadvise(fd, 0, static_cast<off_t>(length), POSIX_FADV_WILLNEED);
+  }
+  ::close(fd);
+#else
+  (void)path;
+  (void)length;
+#endif
+}
+
 std::string strError() {
   int error = errno;
   std::ostringstream os;
@@ -6,6 +6,7 @@
 #include "config.h"
 #include "error.hpp"
 #include "futils.hpp"
+#include "stats_int.hpp"
 
 #include <iostream>
 
@@ -35,6 +36,7 @@ void GifImage::setComment(const std::string&) {
 }
 
 void GifImage::readMetadata() {
+  EXV_STATS_SCOPE("GifImage::readMetadata");
 #ifdef EXIV2_DEBUG_MESSAGES
   std::cerr << "Exiv2::GifImage::readMetadata: Reading GIF file " << io_->path() << "\n";
 #endif
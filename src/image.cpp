@@ -10,6 +10,7 @@
 #include "image_int.hpp"
 #include "safe_op.hpp"
 #include "slice.hpp"
+#include "stats_int.hpp"
 
 #ifdef EXV_ENABLE_BMFF
 #include "bmffimage.hpp"
@@ -50,6 +51,8 @@
 #include <cstring>
 #include <limits>
 #include <set>
+#include <string_view>
+#include <typeinfo>
 
 // *****************************************************************************
 namespace {
@@ -116,6 +119,115 @@ constexpr auto registry = std::array{
 #endif  // EXV_ENABLE_BMFF
 };
 
+//! Magic number of an image type: the bytes a file of that type has at a fixed offset
+struct Magic {
+  ImageType imageType_;
+  size_t offset_;
+  std::string_view bytes_;
+};
+
+/*!
+  @brief Magic numbers used to preselect the image types worth checking.
+
+  A file can only be of a type listed here if it has at least one of the
+  magic numbers of that type, the type check of the registry confirms the
+  match. Types without an entry (TGA) are always checked. Each entry must be
+  a necessary condition of the corresponding type check.
+ */
+constexpr auto magics = std::array{
+    Magic{ImageType::jpeg, 0, "\xff\xd8"},
+    Magic{ImageType::exv, 0, "\xff\x01"
+                             "Exiv2"},
+    Magic{ImageType::cr2, 0, "II"},
+    Magic{ImageType::cr2, 0, "MM"},
+    Magic{ImageType::crw, 6, "HEAPCCDR"},
+    Magic{ImageType::mrw, 0, {"\0MRM", 4}},
+    Magic{ImageType::tiff, 0, "II"},
+    Magic{ImageType::tiff, 0, "MM"},
+    Magic{ImageType::webp, 0, "RIFF"},
+    Magic{ImageType::dng, 0, "II"},
+    Magic{ImageType::dng, 0, "MM"},
+    Magic{ImageType::nef, 0, "II"},
+    Magic{ImageType::nef, 0, "MM"},
+    Magic{ImageType::pef, 0, "II"},
+    Magic{ImageType::pef, 0, "MM"},
+    Magic{ImageType::arw, 0, "II"},
+    Magic{ImageType::arw, 0, "MM"},
+    Magic{ImageType::rw2, 0, "II"},
+    Magic{ImageType::rw2, 0, "MM"},
+    Magic{ImageType::sr2, 0, "II"},
+    Magic{ImageType::sr2, 0, "MM"},
+    Magic{ImageType::srw, 0, "II"},
+    Magic{ImageType::srw, 0, "MM"},
+    Magic{ImageType::orf, 0, "II"},
+    Magic{ImageType::orf, 0, "MM"},
+    Magic{ImageType::png, 0, "\x89PNG\r\n\x1a\n"},
+    Magic{ImageType::pgf, 0, "PGF"},
+    Magic{ImageType::raf, 0, "FUJIFILM"},
+    Magic{ImageType::eps, 0, "\xc5\xd0\xd3\xc6"},
+    Magic{ImageType::eps, 0, "%!PS-Adobe-"},
+    Magic{ImageType::xmp, 0, "<"},
+    Magic{ImageType::xmp, 0, "\xef\xbb\xbf"},
+    Magic{ImageType::gif, 0, "GIF8"},
+    Magic{ImageType::psd, 0, {"8BPS\0\x01", 6}},
+    Magic{ImageType::bmp, 0, "BM"},
+    Magic{ImageType::jp2, 0, {"\0\0\0\x0cjP  \r\n\x87\n", 12}},
+    Magic{ImageType::qtime, 4, "PICT"},
+    Magic{ImageType::qtime, 4, "free"},
+    Magic{ImageType::qtime, 4, "ftyp"},
+    Magic{ImageType::qtime, 4, "junk"},
+    Magic{ImageType::qtime, 4, "mdat"},
+    Magic{ImageType::qtime, 4, "moov"},
+    Magic{ImageType::qtime, 4, "pict"},
+    Magic{ImageType::qtime, 4, "pnot"},
+    Magic{ImageType::qtime, 4, "skip"},
+    Magic{ImageType::qtime, 4, "uuid"},
+    Magic{ImageType::qtime, 4, "wide"},
+    Magic{ImageType::asf, 0, {"\x30\x26\xb2\x75\x8e\x66\xcf\x11\xa6\xd9\x00\xaa\x00\x62\xce\x6c", 16}},
+    Magic{ImageType::riff, 0, "RI"},
+    Magic{ImageType::mkv, 0, "\x1a\x45\xdf\xa3"},
+    Magic{ImageType::bmff, 4, "ftyp"},
+    Magic{ImageType::bmff, 4, "JXL "},
+};
+
+//! Number of bytes read from the start of a file to preselect its type, covers all magic numbers
+constexpr size_t sniffSize = 64;
+
+/*!
+  @brief Return true if the file starting with \em head may be of type \em type.
+         A magic number that extends beyond a short header cannot exclude the type.
+ */
+bool mayBeType(ImageType type, const DataBuf& head) {
+  bool hasMagic = false;
+  for (auto&& m : magics) {
+    if (m.imageType_ != type)
+      continue;
+    hasMagic = true;
+    if (m.offset_ + m.bytes_.size() > head.size() || head.cmpBytes(m.offset_, m.bytes_.data(), m.bytes_.size()) == 0)
+      return true;
+  }
+  return !hasMagic;
+}
+
+/*!
+  @brief Return the registry entry of the type of the open \em io, or nullptr.
+
+  Reads the start of the file once and runs only the type checks of the types
+  whose magic numbers match it, in the order of the registry.
+ */
+const Registry* findType(BasicIo& io) {
+  DataBuf head(sniffSize);
+  const size_t n = io.read(head.data(), head.size());
+  head.resize(io.error() ? 0 : n);
+  io.seek(0, BasicIo::beg);
+  for (const auto& r : registry) {
+    if (mayBeType(r.imageType_, head) && r.isThisType_(io, false)) {
+      return &r;
+    }
+  }
+  return nullptr;
+}
+
 std::string pathOfFileUrl(const std::string& url) {
   std::string path = url.substr(7);
   size_t found = path.find('/');
@@ -289,12 +401,31 @@ static bool typeValid(uint16_t type) {
   return type >= 1 && type <= 13;
 }
 
-static std::set<size_t> visits;  // #547
+struct Image::IfdPrintState {
+  size_t top_;               //!< Depth of the first IFD
+  std::set<size_t> visits_;  //!< Offsets of the entries read so far (#547)
+  size_t bytes_{0};          //!< Number of bytes read to print values
+  bool stop_{false};         //!< Set when the byte budget is exhausted
+};
+
+void Image::setPrintStructureLimits(const PrintStructureLimits& limits) {
+  printStructureLimits_ = limits;
+}
+
+const PrintStructureLimits& Image::printStructureLimits() const {
+  return printStructureLimits_;
+}
 
 void Image::printIFDStructure(BasicIo& io, std::ostream& out, Exiv2::PrintStructureOption option, size_t start,
                               bool bSwap, char c, size_t depth) {
-  if (depth == 1)
-    visits.clear();
+  IfdPrintState state{depth, {}};
+  printIFDStructure(io, out, option, start, bSwap, c, depth, state);
+}
+
+void Image::printIFDStructure(BasicIo& io, std::ostream& out, Exiv2::PrintStructureOption option, size_t start,
+                              bool bSwap, char c, size_t depth, IfdPrintState& state) {
+  const auto& limits = printStructureLimits_;
+  auto& visits = state.visits_;
   bool bFirst = true;
 
   // buffer
@@ -319,7 +450,13 @@ void Image::printIFDStructure(BasicIo& io, std::ostream& out, Exiv2::PrintStruct
     }
 
     // Read the dictionary
-    for (int i = 0; i < dirLength; i++) {
+    for (int i = 0; i < dirLength && !state.stop_; i++) {
+      if (bPrint && static_cast<size_t>(i) >= limits.maxEntries_) {
+        out << Internal::indent(depth) << Internal::stringFormat("%8s | %u more entries", "...", dirLength - i)
+            << std::endl;
+        io.seekOrThrow(start + 2 + dirLength * 12, BasicIo::beg, ErrorCode::kerCorruptedMetadata);
+        break;
+      }
       if (visits.find(io.tell()) != visits.end()) {  // #547
         throw Error(ErrorCode::kerCorruptedMetadata);
       }
@@ -392,6 +529,15 @@ void Image::printIFDStructure(BasicIo& io, std::ostream& out, Exiv2::PrintStruct
       const size_t count_x_size = count * size;
       const bool bOffsetIsPointer = count_x_size > 4;
 
+      if (bPrint && bOffsetIsPointer) {
+        if (count_x_size > limits.maxBytes_ - std::min(state.bytes_, limits.maxBytes_)) {
+          out << Internal::indent(depth) << Internal::stringFormat("%8s | byte limit reached", "...") << std::endl;
+          state.stop_ = true;
+          break;
+        }
+        state.bytes_ += count_x_size;
+      }
+
       if (bOffsetIsPointer) {                                                       // read into buffer
         const size_t restore = io.tell();                                           // save
         io.seekOrThrow(offset, BasicIo::beg, ErrorCode::kerCorruptedMetadata);      // position
@@ -431,14 +577,15 @@ void Image::printIFDStructure(BasicIo& io, std::ostream& out, Exiv2::PrintStruct
         sp = kount == count ? "" : " ...";
         out << sp << std::endl;
 
-        if (option == kpsRecursive && (tag == 0x8769 /* ExifTag */ || tag == 0x014a /*SubIFDs*/ || type == tiffIfd)) {
+        const bool bRecurse = option == kpsRecursive && depth - state.top_ < limits.maxDepth_;
+        if (bRecurse && (tag == 0x8769 /* ExifTag */ || tag == 0x014a /*SubIFDs*/ || type == tiffIfd)) {
           for (size_t k = 0; k < count; k++) {
             const size_t restore = io.tell();
             offset = byteSwap4(buf, k * size, bSwap);
-            printIFDStructure(io, out, option, offset, bSwap, c, depth + 1);
+            printIFDStructure(io, out, option, offset, bSwap, c, depth + 1, state);
             io.seekOrThrow(restore, BasicIo::beg, ErrorCode::kerCorruptedMetadata);
           }
-        } else if (option == kpsRecursive && tag == 0x83bb /* IPTCNAA */) {
+        } else if (bRecurse && tag == 0x83bb /* IPTCNAA */) {
           if (count > 0) {
             if (static_cast<size_t>(Safe::add(count, offset)) > io.size()) {
               throw Error(ErrorCode::kerCorruptedMetadata);
@@ -453,7 +600,7 @@ void Image::printIFDStructure(BasicIo& io, std::ostream& out, Exiv2::PrintStruct
             // TODO: once we have C++11 use bytes.data()
             IptcData::printStructure(out, makeSliceUntil(bytes.data(), count), depth);
           }
-        } else if (option == kpsRecursive && tag == 0x927c /* MakerNote */ && count > 10) {
+        } else if (bRecurse && tag == 0x927c /* MakerNote */ && count > 10) {
           const size_t restore = io.tell();  // save
 
           uint32_t jump = 10;
@@ -477,7 +624,7 @@ void Image::printIFDStructure(BasicIo& io, std::ostream& out, Exiv2::PrintStruct
             // tag is an IFD
             uint32_t punt = bSony ? 12 : 0;
             io.seekOrThrow(0, BasicIo::beg, ErrorCode::kerCorruptedMetadata);  // position
-            printIFDStructure(io, out, option, offset + punt, bSwap, c, depth + 1);
+            printIFDStructure(io, out, option, offset + punt, bSwap, c, depth + 1, state);
           }
 
           io.seekOrThrow(restore, BasicIo::beg, ErrorCode::kerCorruptedMetadata);  // restore
@@ -492,11 +639,11 @@ void Image::printIFDStructure(BasicIo& io, std::ostream& out, Exiv2::PrintStruct
         out.write(buf.c_str(), count);
       }
     }
-    if (start) {
+    if (start && !state.stop_) {
       io.readOrThrow(dir.data(), 4, ErrorCode::kerCorruptedMetadata);
       start = byteSwap4(dir, 0, bSwap);
     }
-  } while (start);
+  } while (start && !state.stop_);
 
   if (bPrint) {
     out << Internal::indent(depth) << "END " << io.path() << std::endl;
@@ -569,6 +716,29 @@ void Image::setMetadata(const Image& image) {
   }
 }
 
+void Image::reopen(BasicIo::UniquePtr io) {
+  io_ = std::move(io);
+  clearMetadata();
+  pixelWidth_ = 0;
+  pixelHeight_ = 0;
+  nativePreviews_.clear();
+  byteOrder_ = invalidByteOrder;
+  doReopen();
+}
+
+void Image::reopen(const std::string& path) {
+  // Only a plain FileIo can be pointed at another file, XPathIo and the remote IO classes are bound to their source
+  if (io_ && fileProtocol(path) == pFile) {
+    BasicIo& io = *io_;
+    if (typeid(io) == typeid(FileIo)) {
+      static_cast<FileIo&>(io).setPath(path);
+      reopen(std::move(io_));
+      return;
+    }
+  }
+  reopen(ImageFactory::createIo(path));
+}
+
 void Image::clearExifData() {
   exifData_.clear();
 }
@@ -778,12 +948,8 @@ ImageType ImageFactory::getType(BasicIo& io) {
   if (io.open() != 0)
     return ImageType::none;
   IoCloser closer(io);
-  for (const auto& r : registry) {
-    if (r.isThisType_(io, false)) {
-      return r.imageType_;
-    }
-  }
-  return ImageType::none;
+  const Registry* r = findType(io);
+  return r ? r->imageType_ : ImageType::none;
 }
 
 BasicIo::UniquePtr ImageFactory::createIo(const std::string& path, bool useCurl) {
@@ -822,13 +988,12 @@ Image::UniquePtr ImageFactory::open(const byte* data, size_t size) {
 }
 
 Image::UniquePtr ImageFactory::open(BasicIo::UniquePtr io) {
+  EXV_STATS_SCOPE("ImageFactory::open");
   if (io->open() != 0) {
     throw Error(ErrorCode::kerDataSourceOpenFailed, io->path(), strError());
   }
-  for (const auto& r : registry) {
-    if (r.isThisType_(*io, false)) {
-      return r.newInstance_(std::move(io), false);
-    }
+  if (const Registry* r = findType(*io)) {
+    return r->newInstance_(std::move(io), false);
   }
   return nullptr;
 }
@@ -13,6 +13,7 @@
 #include "image_int.hpp"
 #include "jp2image_int.hpp"
 #include "safe_op.hpp"
+#include "stats_int.hpp"
 #include "tiffimage.hpp"
 #include "types.hpp"
 
@@ -126,6 +127,7 @@ void Jp2Image::setComment(const std::string&) {
 }
 
 void Jp2Image::readMetadata() {
+  EXV_STATS_SCOPE("Jp2Image::readMetadata");
 #ifdef EXIV2_DEBUG_MESSAGES
   std::cerr << "Exiv2::Jp2Image::readMetadata: Reading JPEG-2000 file " << io_->path() << std::endl;
 #endif
@@ -414,6 +416,11 @@ void Jp2Image::printStructure(std::ostream& out, PrintStructureOption option, si
     Internal::Jp2BoxHeader subBox = {1, 1};
     Internal::Jp2UuidBox uuid = {{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}};
     bool bLF = false;
+    const auto& limits = printStructureLimits();
+    // sub-boxes and the embedded Exif and IPTC data are one level below the boxes
+    const bool bPrintSub = bPrint && limits.maxDepth_ > 0;
+    const bool bRecurse = bRecursive && limits.maxDepth_ > 0;
+    size_t entries = 0;
 
     while (box.length && box.type != kJp2BoxTypeClose &&
            io_->read(reinterpret_cast<byte*>(&box), boxHSize) == boxHSize) {
@@ -422,6 +429,16 @@ void Jp2Image::printStructure(std::ostream& out, PrintStructureOption option, si
       box.type = getULong(reinterpret_cast<byte*>(&box.type), bigEndian);
       enforce(box.length <= boxHSize + io_->size() - io_->tell(), ErrorCode::kerCorruptedMetadata);
 
+      if (bPrint && entries++ >= limits.maxEntries_) {
+        out << Internal::stringFormat("%8s | more boxes", "...") << std::endl;
+        break;
+      }
+      const auto& skipTypes = limits.skipTypes_;
+      if (bPrint && std::find(skipTypes.begin(), skipTypes.end(), toAscii(box.type)) != skipTypes.end()) {
+        io_->seek(static_cast<int64_t>(position - boxHSize + box.length), BasicIo::beg);
+        continue;
+      }
+
       if (bPrint) {
         out << Internal::stringFormat("%8ld | %8ld | ", position - boxHSize, static_cast<size_t>(box.length))
             << toAscii(box.type) << "      | ";
@@ -465,7 +482,7 @@ void Jp2Image::printStructure(std::ostream& out, PrintStructureOption option, si
 
             DataBuf data(subBox.length - boxHSize);
             io_->read(data.data(), data.size());
-            if (bPrint) {
+            if (bPrintSub) {
               out << Internal::stringFormat("%8zu | %8u |  sub:", address, subBox.length) << toAscii(subBox.type)
                   << " | "
                   << Internal::binaryToString(makeSlice(data, 0, std::min(static_cast<size_t>(30), data.size())));
@@ -499,7 +516,7 @@ void Jp2Image::printStructure(std::ostream& out, PrintStructureOption option, si
               } else {  // Restricted ICC Profile
                         // see the ICC Profile Format Specification, version ICC.1:1998-09
                 const size_t iccLength = data.read_uint32(pad, bigEndian);
-                if (bPrint) {
+                if (bPrintSub) {
                   out << " | iccLength:" << iccLength;
                 }
                 enforce(iccLength <= data.size() - pad, ErrorCode::kerCorruptedMetadata);
@@ -546,7 +563,7 @@ void Jp2Image::printStructure(std::ostream& out, PrintStructureOption option, si
             }
             lf(out, bLF);
 
-            if (bIsExif && bRecursive && rawData.size() > 8) {  // "II*\0long"
+            if (bIsExif && bRecurse && rawData.size() > 8) {  // "II*\0long"
               const char a = rawData.read_uint8(0);
               const char b = rawData.read_uint8(1);
               if (a == b && (a == 'I' || a == 'M')) {
@@ -555,7 +572,7 @@ void Jp2Image::printStructure(std::ostream& out, PrintStructureOption option, si
               }
             }
 
-            if (bIsIPTC && bRecursive) {
+            if (bIsIPTC && bRecurse) {
               IptcData::printStructure(out, makeSlice(rawData, 0, rawData.size()), depth);
             }
 
@@ -580,6 +597,7 @@ void Jp2Image::printStructure(std::ostream& out, PrintStructureOption option, si
 }
 
 void Jp2Image::writeMetadata() {
+  EXV_STATS_SCOPE("Jp2Image::writeMetadata");
   if (io_->open() != 0) {
     throw Error(ErrorCode::kerDataSourceOpenFailed, io_->path(), strError());
   }
@@ -11,6 +11,7 @@
 #include "jpgimage.hpp"
 #include "photoshop.hpp"
 #include "safe_op.hpp"
+#include "stats_int.hpp"
 #include "utils.hpp"
 
 #ifdef _WIN32
@@ -87,6 +88,14 @@ std::pair<std::array<byte, 2>, uint16_t> readSegmentSize(const byte marker, Basi
   }
   return {buf, size};
 }
+
+/// @brief Skip the rest of a segment of \em size bytes, the size field of which has already been read.
+void skipSegment(uint16_t size, BasicIo& io) {
+  if (size > 2) {
+    enforce(size - 2U <= io.size() - io.tell(), ErrorCode::kerFailedToReadImageData);
+    io.seekOrThrow(size - 2, BasicIo::cur, ErrorCode::kerFailedToReadImageData);
+  }
+}
 }  // namespace
 
 JpegBase::JpegBase(ImageType type, BasicIo::UniquePtr io, bool create, const byte initData[], size_t dataSize) :
@@ -125,6 +134,7 @@ byte JpegBase::advanceToMarker(ErrorCode err) const {
 }
 
 void JpegBase::readMetadata() {
+  EXV_STATS_SCOPE("JpegBase::readMetadata");
   int rc = 0;  // Todo: this should be the return value
 
   if (io_->open() != 0)
@@ -144,18 +154,26 @@ void JpegBase::readMetadata() {
   bool foundXmpData = false;
   bool foundIccData = false;
 
+  // Segment buffer, reused for all segments
+  DataBuf buf;
+
   // Read section marker
   byte marker = advanceToMarker(ErrorCode::kerNotAJpeg);
 
   while (marker != sos_ && marker != eoi_ && search > 0) {
     const auto [sizebuf, size] = readSegmentSize(marker, *io_);
 
-    // Read the rest of the segment.
-    DataBuf buf(size);
-    /// \todo check if it makes sense to check for size
-    if (size > 0) {
-      io_->readOrThrow(buf.data(2), size - 2, ErrorCode::kerFailedToReadImageData);
-      std::copy(sizebuf.begin(), sizebuf.end(), buf.begin());
+    // Only read the rest of the segments which are decoded below
+    if (marker == app1_ || marker == app2_ || marker == app13_ || marker == com_ ||
+        inRange2(marker, sof0_, sof3_, sof5_, sof15_)) {
+      buf.resize(size);
+      /// \todo check if it makes sense to check for size
+      if (size > 0) {
+        io_->readOrThrow(buf.data(2), size - 2, ErrorCode::kerFailedToReadImageData);
+        std::copy(sizebuf.begin(), sizebuf.end(), buf.begin());
+      }
+    } else {
+      skipSegment(size, *io_);
     }
 
     if (!foundExifData && marker == app1_ && size >= 8  // prevent out-of-bounds read in memcmp on next line
@@ -549,6 +567,7 @@ void JpegBase::printStructure(std::ostream& out, PrintStructureOption option, si
 }  // JpegBase::printStructure
 
 void JpegBase::writeMetadata() {
+  EXV_STATS_SCOPE("JpegBase::writeMetadata");
   if (io_->open() != 0) {
     throw Error(ErrorCode::kerDataSourceOpenFailed, io_->path(), strError());
   }
@@ -560,16 +579,15 @@ void JpegBase::writeMetadata() {
   io_->transfer(tempIo);  // may throw
 }
 
-DataBuf JpegBase::readNextSegment(byte marker) {
+void JpegBase::readNextSegment(byte marker, DataBuf& buf) {
   const auto [sizebuf, size] = readSegmentSize(marker, *io_);
 
   // Read the rest of the segment.
-  DataBuf buf(size);
+  buf.resize(size);
   if (size > 0) {
     io_->readOrThrow(buf.data(2), size - 2, ErrorCode::kerFailedToReadImageData);
     std::copy(sizebuf.begin(), sizebuf.end(), buf.begin());
   }
-  return buf;
 }
 
 void JpegBase::doWriteMetadata(BasicIo& outIo) {
@@ -602,6 +620,7 @@ void JpegBase::doWriteMetadata(BasicIo& outIo) {
   size_t skipCom = notfound;
   Blob psBlob;
   DataBuf rawExif;
+  DataBuf buf;  // Segment buffer, reused for all segments
   xmpData().usePacket(writeXmpFromPacket());
 
   // Write image header
@@ -615,7 +634,7 @@ void JpegBase::doWriteMetadata(BasicIo& outIo) {
   // to insert after it. But if app0 comes after com, app1 and app13 then
   // don't bother.
   while (marker != sos_ && marker != eoi_ && search < 6) {
-    DataBuf buf = readNextSegment(marker);
+    readNextSegment(marker, buf);
 
     if (marker == app0_) {
       insertPos = count + 1;
@@ -704,7 +723,7 @@ void JpegBase::doWriteMetadata(BasicIo& outIo) {
   // potential to change segment ordering (which is allowed).
   // Segments are erased if there is no assigned metadata.
   while (marker != sos_ && search > 0) {
-    DataBuf buf = readNextSegment(marker);
+    readNextSegment(marker, buf);
 
     if (insertPos == count) {
       // Write Exif data first so that - if there is no app0 - we
@@ -912,12 +931,7 @@ void JpegBase::doWriteMetadata(BasicIo& outIo) {
   if (outIo.write(tmpBuf, 2) != 2)
     throw Error(ErrorCode::kerImageWriteFailed);
 
-  DataBuf buf(4096);
-  size_t readSize = 0;
-  while ((readSize = io_->read(buf.data(), buf.size()))) {
-    if (outIo.write(buf.c_data(), readSize) != readSize)
-      throw Error(ErrorCode::kerImageWriteFailed);
-  }
+  outIo.write(*io_);
   if (outIo.error())
     throw Error(ErrorCode::kerImageWriteFailed);
 
@@ -25,6 +25,7 @@
 #include "error.hpp"
 #include "futils.hpp"
 #include "matroskavideo.hpp"
+#include "stats_int.hpp"
 #include "tags.hpp"
 #include "tags_int.hpp"
 
@@ -574,7 +575,7 @@ namespace Exiv2 {
 
 using namespace Exiv2::Internal;
 
-MatroskaVideo::MatroskaVideo(BasicIo::UniquePtr io) : Image(ImageType::mkv, mdNone, std::move(io)) {
+MatroskaVideo::MatroskaVideo(BasicIo::UniquePtr io) : Image(ImageType::mkv, mdNone, std::move(io)), xmp_(xmpData_) {
 }  // MatroskaVideo::MatroskaVideo
 
 std::string MatroskaVideo::mimeType() const {
@@ -584,7 +585,16 @@ std::string MatroskaVideo::mimeType() const {
 void MatroskaVideo::writeMetadata() {
 }
 
+void MatroskaVideo::setValueMaxSize(size_t size) {
+  valueMaxSize_ = size;
+}
+
+size_t MatroskaVideo::valueMaxSize() const {
+  return valueMaxSize_;
+}
+
 void MatroskaVideo::readMetadata() {
+  EXV_STATS_SCOPE("MatroskaVideo::readMetadata");
   if (io_->open() != 0)
     throw Error(ErrorCode::kerDataSourceOpenFailed, io_->path(), strError());
 
@@ -597,20 +607,28 @@ void MatroskaVideo::readMetadata() {
 
   IoCloser closer(*io_);
   clearMetadata();
+  XmpDataFinisher finisher(xmp_);
   continueTraversing_ = true;
   height_ = width_ = 1;
-
-  xmpData_["Xmp.video.FileName"] = io_->path();
-  xmpData_["Xmp.video.FileSize"] = io_->size() / bytesMB;
-  xmpData_["Xmp.video.MimeType"] = mimeType();
+  track_count_ = 0;
+  time_code_scale_ = 1.0;
+  stream_ = 0;
+  segmentStart_ = 0;
+  seekId_ = 0;
+  seekEntries_.clear();
+  attachFileMime_.clear();
+
+  xmp_["Xmp.video.FileName"] = io_->path();
+  xmp_["Xmp.video.FileSize"] = io_->size() / bytesMB;
+  xmp_["Xmp.video.MimeType"] = mimeType();
 
   while (continueTraversing_)
     decodeBlock();
-
   aspectRatio();
 }
 
 void MatroskaVideo::decodeBlock() {
+  const size_t blockStart = io_->tell();
   byte buf[8];
   io_->read(buf, 1);
 
@@ -633,8 +651,9 @@ void MatroskaVideo::decodeBlock() {
 
   // tag->dump(std::cout);
 
+  // The media data starts here; metadata elements may still follow it
   if (tag->_id == Cues || tag->_id == Cluster) {
-    continueTraversing_ = false;
+    continueTraversing_ = seekToNextElement(blockStart);
     return;
   }
 
@@ -645,24 +664,51 @@ void MatroskaVideo::decodeBlock() {
     io_->read(buf + 1, block_size - 1);
   size_t size = returnTagValue(buf, block_size);
 
+  // SeekHead positions are relative to the start of the segment data
+  if (tag->_id == SegmentHeader)
+    segmentStart_ = io_->tell();
+
+  // Each attachment has its own MIME type, an attachment without one must not inherit it
+  if (tag->_id == AttachedFile)
+    attachFileMime_.clear();
+
   if (tag->isComposite() && !tag->isSkipped())
     return;
 
-  const size_t bufMaxSize = 200;
+  if ((tag->_id == SeekID || tag->_id == SeekPosition) && size > 0 && size <= sizeof(buf)) {
+    io_->readOrThrow(buf, size, ErrorCode::kerCorruptedMetadata);
+    uint64_t position = 0;
+    if (tag->_id == SeekID)
+      seekId_ = returnTagValue(buf, size);
+    else if (convertToUint64(buf, size, position))
+      seekEntries_.emplace_back(seekId_, position);
+    return;
+  }
+
+  // Attached pictures are exposed as previews; attachment data is never copied into XMP
+  if (tag->_id == Xmp_video_AttachFileData) {
+    if (attachFileMime_ == "image/jpeg" && size <= io_->size() - io_->tell()) {
+      nativePreviews_.push_back({io_->tell(), size, 0, 0, "", attachFileMime_});
+    }
+    io_->seek(size, BasicIo::cur);
+    return;
+  }
 
 #ifndef SUPPRESS_WARNINGS
-  if (!tag->isSkipped() && size > bufMaxSize) {
+  if (!tag->isSkipped() && size > valueMaxSize_) {
     EXV_WARNING << "Size " << size << " of Matroska tag 0x" << std::hex << tag->_id << std::dec << " is greater than "
-                << bufMaxSize << ": ignoring it.\n";
+                << valueMaxSize_ << ": ignoring it.\n";
   }
 #endif
-  if (tag->isSkipped() || size > bufMaxSize) {
+  if (tag->isSkipped() || size > valueMaxSize_) {
     io_->seek(size, BasicIo::cur);
     return;
   }
 
-  DataBuf buf2(bufMaxSize + 1);
+  DataBuf buf2(size + 1);
   io_->read(buf2.data(), size);
+  if (tag->_id == Xmp_video_AttachFileMIME)
+    attachFileMime_.assign(buf2.c_str(), strnlen(buf2.c_str(), size));
   switch (tag->_type) {
     case InternalField:
       decodeInternalTags(tag, buf2.data(), size);
@@ -693,6 +739,24 @@ void MatroskaVideo::decodeBlock() {
   }
 }  // MatroskaVideo::decodeBlock
 
+bool MatroskaVideo::seekToNextElement(size_t pos) {
+  // Jump to the nearest Info, Tracks, Tags or Attachments element behind pos.
+  // Jumps only go forward, so every element is visited at most once.
+  uint64_t next = 0;
+  for (const auto& [id, offset] : seekEntries_) {
+    if (id != Info && id != Tracks && id != Tags && id != Attachments)
+      continue;
+    if (offset >= io_->size() - segmentStart_)
+      continue;
+    const uint64_t target = segmentStart_ + offset;
+    if (target > pos && (next == 0 || target < next))
+      next = target;
+  }
+  if (next == 0)
+    return false;
+  return io_->seek(static_cast<int64_t>(next), BasicIo::beg) == 0;
+}  // MatroskaVideo::seekToNextElement
+
 void MatroskaVideo::decodeInternalTags(const MatroskaTag* tag, const byte* buf, size_t size) {
   const MatroskaTag* internalMt = nullptr;
   uint64_t key = 0;
@@ -749,18 +813,18 @@ void MatroskaVideo::decodeInternalTags(const MatroskaTag* tag, const byte* buf,
       break;
   }
   if (internalMt) {
-    xmpData_[tag->_label] = internalMt->_label;
+    xmp_[tag->_label] = internalMt->_label;
   } else {
-    xmpData_[tag->_label] = key;
+    xmp_[tag->_label] = key;
   }
 }
 
 void MatroskaVideo::decodeStringTags(const MatroskaTag* tag, const byte* buf) {
   if (tag->_id == TrackNumber) {
     track_count_++;
-    xmpData_[tag->_label] = track_count_;
+    xmp_[tag->_label] = track_count_;
   } else {
-    xmpData_[tag->_label] = buf;
+    xmp_[tag->_label] = buf;
   }
 }
 
@@ -773,7 +837,7 @@ void MatroskaVideo::decodeIntegerTags(const MatroskaTag* tag, const byte* buf, s
     width_ = value;
   if (tag->_id == Xmp_video_Height_1 || tag->_id == Xmp_video_Height_2)
     height_ = value;
-  xmpData_[tag->_label] = value;
+  xmp_[tag->_label] = value;
 }
 
 void MatroskaVideo::decodeBooleanTags(const MatroskaTag* tag, const byte* buf, size_t size) {
@@ -816,7 +880,7 @@ void MatroskaVideo::decodeBooleanTags(const MatroskaTag* tag, const byte* buf, s
 
   if (internalMt) {
     str = "Yes";
-    xmpData_[internalMt->_label] = str;
+    xmp_[internalMt->_label] = str;
   }
 }
 
@@ -831,21 +895,21 @@ void MatroskaVideo::decodeDateTags(const MatroskaTag* tag, const byte* buf, size
       } else {
         duration_in_ms = static_cast<int64_t>(getDouble(buf, bigEndian) * time_code_scale_ * 1000);
       }
-      xmpData_[tag->_label] = duration_in_ms;
+      xmp_[tag->_label] = duration_in_ms;
       break;
     case Xmp_video_DateUTC:
 
       if (!convertToUint64(buf, size, value))
         return;
       duration_in_ms = value / 1000000000;
-      xmpData_[tag->_label] = duration_in_ms;
+      xmp_[tag->_label] = duration_in_ms;
       break;
 
     case TimecodeScale:
       if (!convertToUint64(buf, size, value))
         return;
       time_code_scale_ = static_cast<double>(value) / static_cast<double>(1000000000);
-      xmpData_[tag->_label] = time_code_scale_;
+      xmp_[tag->_label] = time_code_scale_;
       break;
     default:
       break;
@@ -853,13 +917,13 @@ void MatroskaVideo::decodeDateTags(const MatroskaTag* tag, const byte* buf, size
 }
 
 void MatroskaVideo::decodeFloatTags(const MatroskaTag* tag, const byte* buf, size_t size) {
-  xmpData_[tag->_label] = getFloat(buf, bigEndian);
+  xmp_[tag->_label] = getFloat(buf, bigEndian);
 
   double frame_rate = 0;
   switch (tag->_id) {
     case Xmp_audio_SampleRate:
     case Xmp_audio_OutputSampleRate:
-      xmpData_[tag->_label] = getFloat(buf, bigEndian);
+      xmp_[tag->_label] = getFloat(buf, bigEndian);
       break;
     case VideoFrameRate_DefaultDuration:
     case Xmp_video_FrameRate: {
@@ -879,12 +943,12 @@ void MatroskaVideo::decodeFloatTags(const MatroskaTag* tag, const byte* buf, siz
             break;
         }
         if (frame_rate)
-          xmpData_[internalMt->_label] = frame_rate;
+          xmp_[internalMt->_label] = frame_rate;
       } else
-        xmpData_[tag->_label] = "Variable Bit Rate";
+        xmp_[tag->_label] = "Variable Bit Rate";
     } break;
     default:
-      xmpData_[tag->_label] = getFloat(buf, bigEndian);
+      xmp_[tag->_label] = getFloat(buf, bigEndian);
       break;
   }
 }
@@ -892,34 +956,34 @@ void MatroskaVideo::decodeFloatTags(const MatroskaTag* tag, const byte* buf, siz
 void MatroskaVideo::aspectRatio() {
   double aspectRatio = static_cast<double>(width_) / static_cast<double>(height_);
   aspectRatio = floor(aspectRatio * 10) / 10;
-  xmpData_["Xmp.video.AspectRatio"] = aspectRatio;
+  xmp_["Xmp.video.AspectRatio"] = aspectRatio;
 
   auto aR = static_cast<int>((aspectRatio * 10.0) + 0.1);
 
   switch (aR) {
     case 13:
-      xmpData_["Xmp.video.AspectRatio"] = "4:3";
+      xmp_["Xmp.video.AspectRatio"] = "4:3";
       break;
     case 17:
-      xmpData_["Xmp.video.AspectRatio"] = "16:9";
+      xmp_["Xmp.video.AspectRatio"] = "16:9";
       break;
     case 10:
-      xmpData_["Xmp.video.AspectRatio"] = "1:1";
+      xmp_["Xmp.video.AspectRatio"] = "1:1";
       break;
     case 16:
-      xmpData_["Xmp.video.AspectRatio"] = "16:10";
+      xmp_["Xmp.video.AspectRatio"] = "16:10";
       break;
     case 22:
-      xmpData_["Xmp.video.AspectRatio"] = "2.21:1";
+      xmp_["Xmp.video.AspectRatio"] = "2.21:1";
       break;
     case 23:
-      xmpData_["Xmp.video.AspectRatio"] = "2.35:1";
+      xmp_["Xmp.video.AspectRatio"] = "2.35:1";
       break;
     case 12:
-      xmpData_["Xmp.video.AspectRatio"] = "5:4";
+      xmp_["Xmp.video.AspectRatio"] = "5:4";
       break;
     default:
-      xmpData_["Xmp.video.AspectRatio"] = aspectRatio;
+      xmp_["Xmp.video.AspectRatio"] = aspectRatio;
       break;
   }
 }
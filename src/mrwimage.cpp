@@ -9,6 +9,7 @@
 #include "error.hpp"
 #include "futils.hpp"
 #include "image.hpp"
+#include "stats_int.hpp"
 #include "tiffimage.hpp"
 
 #include <iostream>
@@ -54,6 +55,7 @@ void MrwImage::setComment(const std::string&) {
 }
 
 void MrwImage::readMetadata() {
+  EXV_STATS_SCOPE("MrwImage::readMetadata");
 #ifdef EXIV2_DEBUG_MESSAGES
   std::cerr << "Reading MRW file " << io_->path() << "\n";
 #endif
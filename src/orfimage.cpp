@@ -9,6 +9,7 @@
 #include "futils.hpp"
 #include "image.hpp"
 #include "orfimage_int.hpp"
+#include "stats_int.hpp"
 #include "tiffcomposite_int.hpp"
 #include "tiffimage.hpp"
 #include "tiffimage_int.hpp"
@@ -68,6 +69,7 @@ void OrfImage::printStructure(std::ostream& out, PrintStructureOption option, si
 }  // OrfImage::printStructure
 
 void OrfImage::readMetadata() {
+  EXV_STATS_SCOPE("OrfImage::readMetadata");
 #ifdef EXIV2_DEBUG_MESSAGES
   std::cerr << "Reading ORF file " << io_->path() << "\n";
 #endif
@@ -87,6 +89,7 @@ void OrfImage::readMetadata() {
 }
 
 void OrfImage::writeMetadata() {
+  EXV_STATS_SCOPE("OrfImage::writeMetadata");
 #ifdef EXIV2_DEBUG_MESSAGES
   std::cerr << "Writing ORF file " << io_->path() << "\n";
 #endif
@@ -118,19 +121,8 @@ ByteOrder OrfParser::decode(ExifData& exifData, IptcData& iptcData, XmpData& xmp
 
 WriteMethod OrfParser::encode(BasicIo& io, const byte* pData, size_t size, ByteOrder byteOrder,
                               const ExifData& exifData, const IptcData& iptcData, const XmpData& xmpData) {
-  // Copy to be able to modify the Exif data
-  ExifData ed = exifData;
-
-  // Delete IFDs which do not occur in TIFF images
-  static constexpr auto filteredIfds = {
-      IfdId::panaRawId,
-  };
-  for (auto&& filteredIfd : filteredIfds) {
-#ifdef EXIV2_DEBUG_MESSAGES
-    std::cerr << "Warning: Exif IFD " << filteredIfd << " not encoded\n";
-#endif
-    ed.erase(std::remove_if(ed.begin(), ed.end(), FindExifdatum(filteredIfd)), ed.end());
-  }
+  ExifData filtered;
+  const ExifData& ed = filterTiffExifData(exifData, filtered);
 
   OrfHeader header(byteOrder);
   return TiffParserWorker::encode(io, pData, size, ed, iptcData, xmpData, Tag::root, TiffMapping::findEncoder, &header,
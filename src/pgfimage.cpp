@@ -9,6 +9,7 @@
 #include "error.hpp"
 #include "futils.hpp"
 #include "image.hpp"
+#include "stats_int.hpp"
 
 #include <iostream>
 
@@ -65,6 +66,7 @@ PgfImage::PgfImage(BasicIo::UniquePtr io, bool create) :
 }  // PgfImage::PgfImage
 
 void PgfImage::readMetadata() {
+  EXV_STATS_SCOPE("PgfImage::readMetadata");
 #ifdef EXIV2_DEBUG_MESSAGES
   std::cerr << "Exiv2::PgfImage::readMetadata: Reading PGF file " << io_->path() << "\n";
 #endif
@@ -114,6 +116,7 @@ void PgfImage::readMetadata() {
 }
 
 void PgfImage::writeMetadata() {
+  EXV_STATS_SCOPE("PgfImage::writeMetadata");
   if (io_->open() != 0) {
     throw Error(ErrorCode::kerDataSourceOpenFailed, io_->path(), strError());
   }
@@ -201,13 +204,7 @@ void PgfImage::doWriteMetadata(BasicIo& outIo) {
     throw Error(ErrorCode::kerImageWriteFailed);
 
   // Copy the rest of PGF image data.
-
-  DataBuf buf(4096);
-  size_t readSize = 0;
-  while ((readSize = io_->read(buf.data(), buf.size()))) {
-    if (outIo.write(buf.c_data(), readSize) != readSize)
-      throw Error(ErrorCode::kerImageWriteFailed);
-  }
+  outIo.write(*io_);
   if (outIo.error())
     throw Error(ErrorCode::kerImageWriteFailed);
 
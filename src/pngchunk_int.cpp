@@ -17,6 +17,7 @@
 #include "pngchunk_int.hpp"
 #include "safe_op.hpp"
 #include "tiffimage.hpp"
+#include "utils.hpp"
 
 // standard includes
 #include <algorithm>
@@ -25,6 +26,7 @@
 #include <cstring>
 #include <iomanip>
 #include <iostream>
+#include <limits>
 #include <string>
 
 /*
@@ -105,7 +107,7 @@ DataBuf PngChunk::parseTXTChunk(const DataBuf& data, size_t keysize, TxtChunkTyp
     size_t compressedTextSize = data.size() - keysize - nullSeparators;
     enforce(compressedTextSize < data.size(), ErrorCode::kerCorruptedMetadata);
 
-    zlibUncompress(compressedText, static_cast<uint32_t>(compressedTextSize), arr);
+    zlibUncompress(compressedText, compressedTextSize, arr);
   } else if (type == tEXt_Chunk) {
     enforce(data.size() >= Safe::add(keysize, static_cast<size_t>(1)), ErrorCode::kerCorruptedMetadata);
     // Extract a non-compressed Latin-1 text chunk
@@ -336,68 +338,67 @@ std::string PngChunk::makeMetadataChunk(const std::string& metadata, MetadataId
 
 }  // PngChunk::makeMetadataChunk
 
-void PngChunk::zlibUncompress(const byte* compressedText, unsigned int compressedTextSize, DataBuf& arr) {
-  uLongf uncompressedLen = compressedTextSize * 2;  // just a starting point
-  int zlibResult;
-  int dos = 0;
-
-  do {
-    arr.alloc(uncompressedLen);
-    zlibResult = uncompress(arr.data(), &uncompressedLen, compressedText, compressedTextSize);
-    if (zlibResult == Z_OK) {
-      arr.resize(uncompressedLen);
-    } else if (zlibResult == Z_BUF_ERROR) {
-      // the uncompressedArray needs to be larger
-      uncompressedLen *= 2;
-      // DoS protection. can't be bigger than 64k
-      if (uncompressedLen > 131072) {
-        if (++dos > 1)
-          break;
-        uncompressedLen = 131072;
-      }
-    } else {
-      // something bad happened
-      throw Error(ErrorCode::kerFailedToReadImageData);
+bool PngChunk::zlibInflate(const byte* bytes, size_t length, DataBuf& result, size_t maxSize) {
+  z_stream stream{};
+  stream.next_in = const_cast<Bytef*>(bytes);
+  stream.avail_in = static_cast<uInt>(length);
+  if (length > std::numeric_limits<uInt>::max() || inflateInit(&stream) != Z_OK) {
+    result.reset();
+    return false;
+  }
+
+  // Start with twice the compressed size and grow the output as it is
+  // filled, so that the data is only inflated once
+  result.alloc(std::min(std::max(Safe::add(length, length), static_cast<size_t>(1024)), maxSize));
+  int zlibResult = Z_OK;
+  while (zlibResult == Z_OK) {
+    if (stream.total_out == result.size()) {
+      // DoS protection
+      if (result.size() >= maxSize)
+        break;
+      result.resize(std::min(Safe::add(result.size(), result.size()), maxSize));
     }
-  } while (zlibResult == Z_BUF_ERROR);
+    stream.next_out = result.data(stream.total_out);
+    stream.avail_out = static_cast<uInt>(std::min(result.size() - stream.total_out,
+                                                  static_cast<size_t>(std::numeric_limits<uInt>::max())));
+    zlibResult = inflate(&stream, Z_NO_FLUSH);
+  }
+  inflateEnd(&stream);
+
+  if (zlibResult != Z_STREAM_END) {
+    result.reset();
+    return false;
+  }
+  result.resize(stream.total_out);
+  return true;
+}  // PngChunk::zlibInflate
+
+bool PngChunk::zlibDeflate(const byte* bytes, size_t length, DataBuf& result, int level) {
+  if (length > std::numeric_limits<uLong>::max())
+    return false;
+  // compressBound() is large enough to compress the data in one call
+  uLongf compressedLen = compressBound(static_cast<uLong>(length));
+  result.alloc(compressedLen);
+  if (compress2(result.data(), &compressedLen, bytes, static_cast<uLong>(length), level) != Z_OK) {
+    result.reset();
+    return false;
+  }
+  result.resize(compressedLen);
+  return true;
+}  // PngChunk::zlibDeflate
 
-  if (zlibResult != Z_OK) {
+void PngChunk::zlibUncompress(const byte* compressedText, size_t compressedTextSize, DataBuf& arr, size_t maxSize) {
+  if (!zlibInflate(compressedText, compressedTextSize, arr, maxSize)) {
     throw Error(ErrorCode::kerFailedToReadImageData);
   }
 }  // PngChunk::zlibUncompress
 
-std::string PngChunk::zlibCompress(const std::string& text) {
-  auto compressedLen = static_cast<uLongf>(text.size() * 2);  // just a starting point
-  int zlibResult;
-
+std::string PngChunk::zlibCompress(const std::string& text, int level) {
   DataBuf arr;
-  do {
-    arr.resize(compressedLen);
-    zlibResult = compress2(arr.data(), &compressedLen, reinterpret_cast<const Bytef*>(text.data()),
-                           static_cast<uLong>(text.size()), Z_BEST_COMPRESSION);
-
-    switch (zlibResult) {
-      case Z_OK:
-        arr.resize(compressedLen);
-        break;
-      case Z_BUF_ERROR:
-        // The compressed array needs to be larger
-#ifdef EXIV2_DEBUG_MESSAGES
-        std::cout << "Exiv2::PngChunk::parsePngChunk: doubling size for compression.\n";
-#endif
-        compressedLen *= 2;
-        // DoS protection. Cap max compressed size
-        if (compressedLen > 131072)
-          throw Error(ErrorCode::kerFailedToReadImageData);
-        break;
-      default:
-        // Something bad happened
-        throw Error(ErrorCode::kerFailedToReadImageData);
-    }
-  } while (zlibResult == Z_BUF_ERROR);
-
+  if (!zlibDeflate(reinterpret_cast<const byte*>(text.data()), text.size(), arr, level)) {
+    throw Error(ErrorCode::kerFailedToReadImageData);
+  }
   return {arr.c_str(), arr.size()};
-
 }  // PngChunk::zlibCompress
 
 std::string PngChunk::makeAsciiTxtChunk(const std::string& keyword, const std::string& text, bool compress) {
@@ -476,12 +477,6 @@ DataBuf PngChunk::readRawProfile(const DataBuf& text, bool iTXt) {
   }
 
   DataBuf info;
-  const unsigned char unhex[103] = {
-      0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  0,  0,  0,  0,  0,  0, 0,
-      0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 0, 0, 0, 0, 0,  0,  0,  0,  0,  0,  0, 0,
-      0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 10, 11, 12, 13, 14, 15,
-  };
-
   if (iTXt) {
     info.alloc(text.size());
     std::copy(text.cbegin(), text.cend(), info.begin());
@@ -557,9 +552,23 @@ DataBuf PngChunk::readRawProfile(const DataBuf& text, bool iTXt) {
   unsigned char* dp = info.data();  // decode pointer
   size_t nibbles = length * 2;
 
-  for (size_t i = 0; i < nibbles; i++) {
+  size_t i = 0;
+  while (i < nibbles) {
+    // Fast path: decode pairs of hex digits until the next separator
+    while (i % 2 == 0 && i < nibbles && eot - sp >= 2) {
+      const auto hi = hexDigitValues[static_cast<byte>(sp[0])];
+      const auto lo = hexDigitValues[static_cast<byte>(sp[1])];
+      if (hi == notAHexDigit || lo == notAHexDigit)
+        break;
+      *dp++ = static_cast<unsigned char>(16 * hi + lo);
+      sp += 2;
+      i += 2;
+    }
+    if (i == nibbles)
+      break;
+
     enforce(sp < eot, Exiv2::ErrorCode::kerCorruptedMetadata);
-    while (*sp < '0' || (*sp > '9' && *sp < 'a') || *sp > 'f') {
+    while (hexDigitValues[static_cast<byte>(*sp)] == notAHexDigit) {
       if (*sp == '\0') {
 #ifdef EXIV2_DEBUG_MESSAGES
         std::cerr << "Exiv2::PngChunk::readRawProfile: Unable To Copy Raw Profile: ran out of data\n";
@@ -571,10 +580,12 @@ DataBuf PngChunk::readRawProfile(const DataBuf& text, bool iTXt) {
       enforce(sp < eot, Exiv2::ErrorCode::kerCorruptedMetadata);
     }
 
+    const auto v = hexDigitValues[static_cast<byte>(*sp++)];
     if (i % 2 == 0)
-      *dp = static_cast<unsigned char>(16 * unhex[static_cast<int>(*sp++)]);
+      *dp = static_cast<unsigned char>(16 * v);
     else
-      (*dp++) += unhex[static_cast<int>(*sp++)];
+      (*dp++) += v;
+    ++i;
   }
 
   return info;
@@ -582,19 +593,21 @@ DataBuf PngChunk::readRawProfile(const DataBuf& text, bool iTXt) {
 }  // PngChunk::readRawProfile
 
 std::string PngChunk::writeRawProfile(const std::string& profileData, const char* profileType) {
-  static const byte hex[16] = {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'};
-
   std::ostringstream oss;
   oss << '\n' << profileType << '\n' << std::setw(8) << profileData.size();
+  std::string result = oss.str();
+
+  // Two hex digits per byte, a newline every 36 bytes and a final newline
+  result.reserve(result.size() + 2 * profileData.size() + profileData.size() / 36 + 2);
   auto sp = reinterpret_cast<const byte*>(profileData.data());
   for (std::string::size_type i = 0; i < profileData.size(); ++i) {
     if (i % 36 == 0)
-      oss << '\n';
-    oss << hex[*sp >> 4 & 0x0fU];
-    oss << hex[*sp++ & 0x0fU];
+      result += '\n';
+    result += hexDigits[*sp >> 4 & 0x0fU];
+    result += hexDigits[*sp++ & 0x0fU];
   }
-  oss << '\n';
-  return oss.str();
+  result += '\n';
+  return result;
 
 }  // PngChunk::writeRawProfile
 
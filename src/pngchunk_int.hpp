@@ -72,6 +72,57 @@ class PngChunk {
   */
   static std::string makeMetadataChunk(const std::string& metadata, MetadataId type);
 
+  //! Default limit for the size of uncompressed chunk data (DoS protection)
+  static constexpr size_t zlibMaxSize = 32 * 1024 * 1024;
+  //! Default compression level for chunk data (Z_BEST_COMPRESSION)
+  static constexpr int zlibLevel = 9;
+
+  /*!
+    @brief Uncompress zlib data in a single pass, growing \em result as the
+           data is inflated.
+
+    @param bytes   Compressed data.
+    @param length  Size of the compressed data.
+    @param result  Buffer for the uncompressed data, reset on failure.
+    @param maxSize Maximum size of the uncompressed data.
+    @return true if successful, false if the data is corrupt or larger than \em maxSize.
+   */
+  static bool zlibInflate(const byte* bytes, size_t length, DataBuf& result, size_t maxSize = zlibMaxSize);
+
+  /*!
+    @brief Compress data with zlib in a single pass.
+
+    @param bytes  Data to compress.
+    @param length Size of the data.
+    @param result Buffer for the compressed data.
+    @param level  zlib compression level.
+    @return true if successful.
+   */
+  static bool zlibDeflate(const byte* bytes, size_t length, DataBuf& result, int level = zlibLevel);
+
+  /*!
+    @brief Wrapper around zlib to uncompress a PNG chunk content.
+    @throw Error if the data is corrupt or uncompresses to more than \em maxSize bytes.
+   */
+  static void zlibUncompress(const byte* compressedText, size_t compressedTextSize, DataBuf& arr,
+                             size_t maxSize = zlibMaxSize);
+
+  /*!
+    @brief Wrapper around zlib to compress a PNG chunk content.
+   */
+  static std::string zlibCompress(const std::string& text, int level = zlibLevel);
+
+  /*!
+    @brief Decode from ImageMagick raw text profile which host encoded Exif/Iptc/Xmp metadata byte array.
+   */
+  static DataBuf readRawProfile(const DataBuf& text, bool iTXt);
+
+  /*!
+    @brief Encode to ImageMagick raw text profile, which host encoded
+           Exif/IPTC/XMP metadata byte arrays.
+   */
+  static std::string writeRawProfile(const std::string& profileData, const char* profileType);
+
  private:
   /*!
     @brief Parse PNG Text chunk to determine type and extract content.
@@ -112,27 +163,6 @@ class PngChunk {
   */
   static std::string makeUtf8TxtChunk(const std::string& keyword, const std::string& text, bool compress);
 
-  /*!
-    @brief Wrapper around zlib to uncompress a PNG chunk content.
-   */
-  static void zlibUncompress(const byte* compressedText, unsigned int compressedTextSize, DataBuf& arr);
-
-  /*!
-    @brief Wrapper around zlib to compress a PNG chunk content.
-   */
-  static std::string zlibCompress(const std::string& text);
-
-  /*!
-    @brief Decode from ImageMagick raw text profile which host encoded Exif/Iptc/Xmp metadata byte array.
-   */
-  static DataBuf readRawProfile(const DataBuf& text, bool iTXt);
-
-  /*!
-    @brief Encode to ImageMagick raw text profile, which host encoded
-           Exif/IPTC/XMP metadata byte arrays.
-   */
-  static std::string writeRawProfile(const std::string& profileData, const char* profileType);
-
   friend class Exiv2::PngImage;
 
 };  // class PngChunk
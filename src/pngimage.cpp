@@ -16,10 +16,12 @@
 #include "photoshop.hpp"
 #include "pngchunk_int.hpp"
 #include "pngimage.hpp"
+#include "stats_int.hpp"
 #include "tiffimage.hpp"
 #include "types.hpp"
 #include "utils.hpp"
 
+#include <algorithm>
 #include <array>
 #include <iostream>
 
@@ -71,71 +73,7 @@ std::string PngImage::mimeType() const {
   return "image/png";
 }
 
-static bool zlibToDataBuf(const byte* bytes, uLongf length, DataBuf& result) {
-  uLongf uncompressedLen = length;  // just a starting point
-  int zlibResult = Z_BUF_ERROR;
-
-  do {
-    result.alloc(uncompressedLen);
-    zlibResult = uncompress(result.data(), &uncompressedLen, bytes, length);
-    // if result buffer is large than necessary, redo to fit perfectly.
-    if (zlibResult == Z_OK && uncompressedLen < result.size()) {
-      result.reset();
-
-      result.alloc(uncompressedLen);
-      zlibResult = uncompress(result.data(), &uncompressedLen, bytes, length);
-    }
-    if (zlibResult == Z_BUF_ERROR) {
-      // the uncompressed buffer needs to be larger
-      result.reset();
-
-      // Sanity - never bigger than 16mb
-      if (uncompressedLen > 16 * 1024 * 1024)
-        zlibResult = Z_DATA_ERROR;
-      else
-        uncompressedLen *= 2;
-    }
-  } while (zlibResult == Z_BUF_ERROR);
-
-  return zlibResult == Z_OK;
-}
-
-static bool zlibToCompressed(const byte* bytes, uLongf length, DataBuf& result) {
-  uLongf compressedLen = length;  // just a starting point
-  int zlibResult = Z_BUF_ERROR;
-
-  do {
-    result.alloc(compressedLen);
-    zlibResult = compress(result.data(), &compressedLen, bytes, length);
-    if (zlibResult == Z_BUF_ERROR) {
-      // the compressedArray needs to be larger
-      result.reset();
-      compressedLen *= 2;
-    } else {
-      result.reset();
-      result.alloc(compressedLen);
-      zlibResult = compress(result.data(), &compressedLen, bytes, length);
-    }
-  } while (zlibResult == Z_BUF_ERROR);
-
-  return zlibResult == Z_OK;
-}
-
 static bool tEXtToDataBuf(const byte* bytes, size_t length, DataBuf& result) {
-  static std::array<int, 256> value;
-  static bool bFirst = true;
-  if (bFirst) {
-    value.fill(0);
-    for (int i = 0; i < 10; i++) {
-      value['0' + i] = i + 1;
-    }
-    for (int i = 0; i < 6; i++) {
-      value['a' + i] = i + 10 + 1;
-      value['A' + i] = i + 10 + 1;
-    }
-    bFirst = false;
-  }
-
   // calculate length and allocate result;
   // count: number of \n in the header
   size_t count = 0;
@@ -153,7 +91,7 @@ static bool tEXtToDataBuf(const byte* bytes, size_t length, DataBuf& result) {
     }
   }
   for (size_t i = 0; i < length; i++)
-    if (value[p[i]])
+    if (hexDigitValues[p[i]] != notAHexDigit)
       ++count;
   result.alloc((count + 1) / 2);
 
@@ -162,8 +100,8 @@ static bool tEXtToDataBuf(const byte* bytes, size_t length, DataBuf& result) {
   byte* r = result.data();
   int n = 0;  // nibble
   for (size_t i = 0; i < length; i++) {
-    if (value[p[i]]) {
-      int v = value[p[i]] - 1;
+    const int v = hexDigitValues[p[i]];
+    if (v != notAHexDigit) {
       if (++count % 2)
         n = v * 16;  // leading digit
       else
@@ -204,11 +142,19 @@ void PngImage::printStructure(std::ostream& out, PrintStructureOption option, si
       out << " address | chunk |  length | data                           | checksum" << std::endl;
     }
 
+    const auto& limits = printStructureLimits();
+    size_t entries = 0;
+    size_t bytes = 0;
+
     const size_t imgSize = io_->size();
     DataBuf cheaderBuf(8);
 
     while (!io_->eof() && ::strcmp(chType, "IEND") != 0) {
       const size_t address = io_->tell();
+      if (bPrint && entries++ >= limits.maxEntries_) {
+        out << Internal::stringFormat("%8s | more chunks", "...") << std::endl;
+        break;
+      }
 
       size_t bufRead = io_->read(cheaderBuf.data(), cheaderBuf.size());
       if (io_->error())
@@ -228,16 +174,22 @@ void PngImage::printStructure(std::ostream& out, PrintStructureOption option, si
         throw Exiv2::Error(ErrorCode::kerFailedToReadImageData);
       }
 
-      DataBuf buff(dataOffset);
-      if (dataOffset > 0) {
-        bufRead = io_->read(buff.data(), dataOffset);
-        enforce(bufRead == dataOffset, ErrorCode::kerFailedToReadImageData);
+      if (bPrint && std::find(limits.skipTypes_.begin(), limits.skipTypes_.end(), chType) != limits.skipTypes_.end()) {
+        io_->seek(dataOffset + 4, BasicIo::cur);  // jump past checksum
+        continue;
       }
-      io_->seek(restore, BasicIo::beg);
 
-      // format output
+      // only the start of the chunk is printed
       const int iMax = 30;
       const uint32_t blen = dataOffset > iMax ? iMax : dataOffset;
+      DataBuf buff(blen);
+      if (blen > 0) {
+        bufRead = io_->read(buff.data(), blen);
+        enforce(bufRead == blen, ErrorCode::kerFailedToReadImageData);
+      }
+      io_->seek(restore, BasicIo::beg);
+
+      // format output
       std::string dataString;
       // if blen == 0 => slice construction fails
       if (blen > 0) {
@@ -278,6 +230,10 @@ void PngImage::printStructure(std::ostream& out, PrintStructureOption option, si
       bool bComm = option == kpsRecursive && findi(dataStringU, commKey) == 0;
       bool bDesc = option == kpsRecursive && findi(dataStringU, descKey) == 0;
       bool bDump = bXMP || bExif || bIptc || bSoft || bComm || bDesc || iCCP || eXIf;
+      if (bDump && bPrint) {
+        bDump = dataOffset <= limits.maxBytes_ - std::min(bytes, limits.maxBytes_);
+        bytes += dataOffset;
+      }
 
       if (bDump) {
         DataBuf dataBuf;
@@ -300,8 +256,8 @@ void PngImage::printStructure(std::ostream& out, PrintStructureOption option, si
         }
         if (zTXt || iCCP) {
           enforce(dataOffset - name_l - 1 <= std::numeric_limits<uLongf>::max(), ErrorCode::kerCorruptedMetadata);
-          bGood = zlibToDataBuf(data.c_data(name_l + 1), static_cast<uLongf>(dataOffset - name_l - 1),
-                                dataBuf);  // +1 = 'compressed' flag
+          bGood = PngChunk::zlibInflate(data.c_data(name_l + 1), dataOffset - name_l - 1,
+                                        dataBuf);  // +1 = 'compressed' flag
         }
         if (iTXt) {
           bGood = (3 <= dataOffset) && (start < dataOffset - 3);  // good if not a nul chunk
@@ -342,7 +298,7 @@ void PngImage::printStructure(std::ostream& out, PrintStructureOption option, si
             std::copy(dataBuf.begin(), dataBuf.end(), s.begin());  // copy in the dataBuf
             s.write_uint8(dataBuf.size(), 0);                      // nul terminate it
             const auto str = s.c_str();                            // give it name
-            out << Internal::indent(depth) << buff.c_str() << ": " << str;
+            out << Internal::indent(depth) << data.c_str() << ": " << str;
             bLF = true;
           }
 
@@ -352,7 +308,7 @@ void PngImage::printStructure(std::ostream& out, PrintStructureOption option, si
           }
 
           if (bDesc && iTXt) {
-            DataBuf decoded = PngChunk::decodeTXTChunk(buff, PngChunk::iTXt_Chunk);
+            DataBuf decoded = PngChunk::decodeTXTChunk(DataBuf(data.c_data(), dataOffset), PngChunk::iTXt_Chunk);
             out.write(decoded.c_str(), decoded.size());
             bLF = true;
           }
@@ -388,6 +344,7 @@ void readChunk(DataBuf& buffer, BasicIo& io) {
 }
 
 void PngImage::readMetadata() {
+  EXV_STATS_SCOPE("PngImage::readMetadata");
 #ifdef EXIV2_DEBUG_MESSAGES
   std::cerr << "Exiv2::PngImage::readMetadata: Reading PNG file " << io_->path() << std::endl;
 #endif
@@ -452,7 +409,7 @@ void PngImage::readMetadata() {
         ++iccOffset;  // +1 = 'compressed' flag
         enforce(iccOffset <= chunkLength, Exiv2::ErrorCode::kerCorruptedMetadata);
 
-        zlibToDataBuf(chunkData.c_data(iccOffset), static_cast<uLongf>(chunkLength - iccOffset), iccProfile_);
+        PngChunk::zlibInflate(chunkData.c_data(iccOffset), chunkLength - iccOffset, iccProfile_);
 #ifdef EXIV2_DEBUG_MESSAGES
         std::cout << "Exiv2::PngImage::readMetadata: profile name: " << profileName_ << std::endl;
         std::cout << "Exiv2::PngImage::readMetadata: iccProfile.size_ (uncompressed) : " << iccProfile_.size()
@@ -477,6 +434,7 @@ void PngImage::readMetadata() {
 }  // PngImage::readMetadata
 
 void PngImage::writeMetadata() {
+  EXV_STATS_SCOPE("PngImage::writeMetadata");
   if (io_->open() != 0) {
     throw Error(ErrorCode::kerDataSourceOpenFailed, io_->path(), strError());
   }
@@ -611,7 +569,7 @@ void PngImage::doWriteMetadata(BasicIo& outIo) {
       if (iccProfileDefined()) {
         DataBuf compressed;
         enforce(iccProfile_.size() <= std::numeric_limits<uLongf>::max(), ErrorCode::kerCorruptedMetadata);
-        if (zlibToCompressed(iccProfile_.c_data(), static_cast<uLongf>(iccProfile_.size()), compressed)) {
+        if (PngChunk::zlibDeflate(iccProfile_.c_data(), iccProfile_.size(), compressed)) {
           const auto nameLength = static_cast<uint32_t>(profileName_.size());
           const uint32_t chunkLength = nameLength + 2 + static_cast<uint32_t>(compressed.size());
           byte length[4];
@@ -681,6 +639,10 @@ void PngImage::doWriteMetadata(BasicIo& outIo) {
 
 }  // PngImage::doWriteMetadata
 
+void PngImage::doReopen() {
+  profileName_.clear();
+}
+
 // *************************************************************************
 // free functions
 Image::UniquePtr newPngInstance(BasicIo::UniquePtr io, bool create) {
@@ -11,6 +11,7 @@
 #include "image.hpp"
 #include "jpgimage.hpp"
 #include "photoshop.hpp"
+#include "stats_int.hpp"
 
 #include <iostream>
 
@@ -113,6 +114,7 @@ void PsdImage::setComment(const std::string&) {
 }
 
 void PsdImage::readMetadata() {
+  EXV_STATS_SCOPE("PsdImage::readMetadata");
 #ifdef EXIV2_DEBUG_MESSAGES
   std::cerr << "Exiv2::PsdImage::readMetadata: Reading Photoshop file " << io_->path() << "\n";
 #endif
@@ -311,6 +313,7 @@ void PsdImage::readResourceBlock(uint16_t resourceId, uint32_t resourceSize) {
 }  // PsdImage::readResourceBlock
 
 void PsdImage::writeMetadata() {
+  EXV_STATS_SCOPE("PsdImage::writeMetadata");
   if (io_->open() != 0) {
     throw Error(ErrorCode::kerDataSourceOpenFailed, io_->path(), strError());
   }
@@ -389,7 +392,6 @@ void PsdImage::doWriteMetadata(BasicIo& outIo) {
     throw Error(ErrorCode::kerNotAnImage, "Photoshop");
 
   uint32_t oldResLength = getULong(buf, bigEndian);
-  uint32_t newResLength = 0;
 
   // Write oldResLength (will be updated later)
   ul2Data(buf, oldResLength, bigEndian);
@@ -400,6 +402,33 @@ void PsdImage::doWriteMetadata(BasicIo& outIo) {
   std::cerr << std::dec << "oldResLength: " << oldResLength << "\n";
 #endif
 
+  const uint32_t newResLength = writeResourceBlocks(outIo, oldResLength);
+
+  // Populate the fake data, only make sense for remoteio, httpio and sshio.
+  // it avoids allocating memory for parts of the file that contain image-date.
+  io_->populateFakeData();
+
+  // Copy remaining data
+  outIo.write(*io_);
+  if (outIo.error())
+    throw Error(ErrorCode::kerImageWriteFailed);
+
+    // Update length of resources
+#ifdef EXIV2_DEBUG_MESSAGES
+  std::cerr << "newResLength: " << newResLength << "\n";
+#endif
+  outIo.seek(resLenOffset, BasicIo::beg);
+  ul2Data(buf, newResLength, bigEndian);
+  if (outIo.write(buf, 4) != 4)
+    throw Error(ErrorCode::kerImageWriteFailed);
+
+}  // PsdImage::doWriteMetadata
+
+uint32_t PsdImage::writeResourceBlocks(BasicIo& outIo, uint32_t oldResLength) {
+  DataBuf lbuf(4096);
+  byte buf[8];
+  uint32_t newResLength = 0;
+
   // Iterate over original resource blocks.
   // Replace or insert IPTC, EXIF and XMP
   // Original resource blocks assumed to be sorted ASC
@@ -482,7 +511,7 @@ void PsdImage::doWriteMetadata(BasicIo& outIo) {
       if (outIo.write(buf, 4) != 4)
         throw Error(ErrorCode::kerImageWriteFailed);
 
-      readTotal = 0;
+      size_t readTotal = 0;
       while (readTotal < pResourceSize) {
         /// \todo almost same code as in lines 403-410. Factor out & reuse!
         size_t toRead = (pResourceSize - readTotal) < lbuf.size() ? pResourceSize - readTotal : lbuf.size();
@@ -518,29 +547,8 @@ void PsdImage::doWriteMetadata(BasicIo& outIo) {
     newResLength += writeXmpData(xmpData_, outIo);
   }
 
-  // Populate the fake data, only make sense for remoteio, httpio and sshio.
-  // it avoids allocating memory for parts of the file that contain image-date.
-  io_->populateFakeData();
-
-  // Copy remaining data
-  size_t readSize = 0;
-  while ((readSize = io_->read(lbuf.data(), lbuf.size()))) {
-    if (outIo.write(lbuf.c_data(), readSize) != readSize)
-      throw Error(ErrorCode::kerImageWriteFailed);
-  }
-  if (outIo.error())
-    throw Error(ErrorCode::kerImageWriteFailed);
-
-    // Update length of resources
-#ifdef EXIV2_DEBUG_MESSAGES
-  std::cerr << "newResLength: " << newResLength << "\n";
-#endif
-  outIo.seek(resLenOffset, BasicIo::beg);
-  ul2Data(buf, newResLength, bigEndian);
-  if (outIo.write(buf, 4) != 4)
-    throw Error(ErrorCode::kerImageWriteFailed);
-
-}  // PsdImage::doWriteMetadata
+  return newResLength;
+}  // PsdImage::writeResourceBlocks
 
 uint32_t PsdImage::writeIptcData(const IptcData& iptcData, BasicIo& out) {
   uint32_t resLength = 0;
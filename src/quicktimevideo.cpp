@@ -27,11 +27,14 @@
 #include "futils.hpp"
 #include "quicktimevideo.hpp"
 #include "safe_op.hpp"
+#include "stats_int.hpp"
 #include "tags.hpp"
 #include "tags_int.hpp"
 // + standard includes
+#include <algorithm>
 #include <array>
 #include <cmath>
+#include <cstring>
 #include <iostream>
 #include <string>
 // *****************************************************************************
@@ -427,7 +430,7 @@ enum mediaHeaderTags {
 };
 enum handlerTags { HandlerClass = 1, HandlerType, HandlerVendorID };
 enum videoHeaderTags { GraphicsMode = 2, OpColor };
-enum stream { Video, Audio, Hint, Null, GenMediaHeader };
+enum stream { Video, Audio, Hint, Null, GenMediaHeader, TimedMetadata };
 enum imageDescTags {
   codec,
   VendorID = 4,
@@ -489,6 +492,93 @@ bool dataIgnoreList(Exiv2::DataBuf& buf) {
 
   return false;
 }
+
+/*!
+  @brief Function used to recognize the sample size, sample to chunk and
+      chunk offset tables, which are needed to locate timed metadata samples.
+  @param buf Data buffer that will contain Tag to compare
+  @return Returns true, if Tag is one of these tables
+ */
+bool sampleTableList(Exiv2::DataBuf& buf) {
+  return equalsQTimeTag(buf, "stsz") || equalsQTimeTag(buf, "stsc") || equalsQTimeTag(buf, "stco") ||
+         equalsQTimeTag(buf, "co64");
+}
+
+//! Largest number of bytes fetched by a single read of adjacent samples
+constexpr size_t maxSampleRunSize = 1024 * 1024;
+//! Number of samples read at once while decoding a GPS track
+constexpr size_t gpsSampleBatchSize = 256;
+//! Deepest nesting of GPMF containers that is decoded
+constexpr int maxGpmfDepth = 8;
+
+/*!
+  @brief Append the GPS5 positions of a GoPro GPMF sample to \em track. The
+      values are divided by the SCAL entry which precedes them in the same
+      stream. The positions are spread evenly over the sample duration.
+ */
+void decodeGpmfGps(const byte* data, size_t size, const TimedSample& sample, std::vector<GpsPoint>& track,
+                   int depth = 0) {
+  std::array<double, 3> scale{1, 1, 1};
+  size_t pos = 0;
+  while (size - pos >= 8) {
+    // Key, value type, structure size and repeat count
+    const byte* klv = data + pos;
+    const byte type = klv[4];
+    const size_t structSize = klv[5];
+    const size_t repeat = getUShort(klv + 6, bigEndian);
+    const size_t length = structSize * repeat;
+    const size_t padded = (length + 3) & ~static_cast<size_t>(3);
+    if (padded > size - pos - 8)
+      break;
+    const byte* value = klv + 8;
+
+    if (type == 0) {
+      if (depth < maxGpmfDepth)
+        decodeGpmfGps(value, length, sample, track, depth + 1);
+    } else if (std::memcmp(klv, "SCAL", 4) == 0 && (type == 'l' || type == 'L' || type == 's' || type == 'S')) {
+      const size_t width = (type == 'l' || type == 'L') ? 4 : 2;
+      for (size_t i = 0; i < scale.size() && structSize == width && repeat != 0; ++i) {
+        // A single divisor applies to all values
+        const byte* v = value + width * std::min(i, repeat - 1);
+        double divisor = 0;
+        if (type == 'l')
+          divisor = getLong(v, bigEndian);
+        else if (type == 'L')
+          divisor = getULong(v, bigEndian);
+        else if (type == 's')
+          divisor = getShort(v, bigEndian);
+        else
+          divisor = getUShort(v, bigEndian);
+        scale[i] = divisor != 0 ? divisor : 1;
+      }
+    } else if (std::memcmp(klv, "GPS5", 4) == 0 && type == 'l' && structSize == 20) {
+      for (size_t i = 0; i < repeat; ++i) {
+        const byte* v = value + 20 * i;
+        track.push_back({sample.time_ + sample.duration_ * static_cast<double>(i) / static_cast<double>(repeat),
+                         getLong(v, bigEndian) / scale[0], getLong(v + 4, bigEndian) / scale[1],
+                         getLong(v + 8, bigEndian) / scale[2]});
+      }
+    }
+    pos += 8 + padded;
+  }
+}
+
+/*!
+  @brief Append the position of a CAMM sample to \em track, if it is a
+      position (type 5) or a GPS packet with a fix (type 6).
+ */
+void decodeCammGps(const byte* data, size_t size, const TimedSample& sample, std::vector<GpsPoint>& track) {
+  if (size < 4)
+    return;
+  const uint16_t type = getUShort(data + 2, littleEndian);
+  if (type == 5 && size >= 28) {
+    track.push_back({sample.time_, getDouble(data + 4, littleEndian), getDouble(data + 12, littleEndian),
+                     getDouble(data + 20, littleEndian)});
+  } else if (type == 6 && size >= 36 && getLong(data + 12, littleEndian) != 0) {
+    track.push_back({sample.time_, getDouble(data + 16, littleEndian), getDouble(data + 24, littleEndian),
+                     getFloat(data + 32, littleEndian)});
+  }
+}
 }  // namespace Exiv2::Internal
 
 namespace Exiv2 {
@@ -496,7 +586,7 @@ namespace Exiv2 {
 using namespace Exiv2::Internal;
 
 QuickTimeVideo::QuickTimeVideo(BasicIo::UniquePtr io) :
-    Image(ImageType::qtime, mdNone, std::move(io)), timeScale_(1), currentStream_(Null) {
+    Image(ImageType::qtime, mdNone, std::move(io)), timeScale_(1), currentStream_(Null), xmp_(xmpData_) {
 }  // QuickTimeVideo::QuickTimeVideo
 
 std::string QuickTimeVideo::mimeType() const {
@@ -507,6 +597,7 @@ void QuickTimeVideo::writeMetadata() {
 }
 
 void QuickTimeVideo::readMetadata() {
+  EXV_STATS_SCOPE("QuickTimeVideo::readMetadata");
   if (io_->open() != 0)
     throw Error(ErrorCode::kerDataSourceOpenFailed, io_->path(), strError());
 
@@ -519,15 +610,20 @@ void QuickTimeVideo::readMetadata() {
 
   IoCloser closer(*io_);
   clearMetadata();
+  XmpDataFinisher finisher(xmp_);
   continueTraversing_ = true;
   height_ = width_ = 1;
+  timeScale_ = 1;
+  currentStream_ = Null;
+  sampleTable_ = SampleTable();
+  timedMetadataTracks_.clear();
 
-  xmpData_["Xmp.video.FileSize"] = static_cast<double>(io_->size()) / static_cast<double>(1048576);
-  xmpData_["Xmp.video.MimeType"] = mimeType();
+  xmp_["Xmp.video.FileSize"] = static_cast<double>(io_->size()) / static_cast<double>(1048576);
+  xmp_["Xmp.video.MimeType"] = mimeType();
 
   while (continueTraversing_)
     decodeBlock();
-
+  addTimedMetadataTrack();
   aspectRatio();
 }  // QuickTimeVideo::readMetadata
 
@@ -568,10 +664,9 @@ void QuickTimeVideo::decodeBlock(std::string const& entered_from) {
   enforce(size - hdrsize <= std::numeric_limits<size_t>::max(), Exiv2::ErrorCode::kerCorruptedMetadata);
 
   // std::cerr<<"Tag=>"<<buf.data()<<"     size=>"<<size-hdrsize << std::endl;
+  // buf only carries the atom type; the decoders read the payload themselves,
+  // and atoms such as mdat are skipped without being buffered.
   const auto newsize = static_cast<size_t>(size - hdrsize);
-  if (newsize > buf.size()) {
-    buf.resize(newsize);
-  }
   tagDecoder(buf, newsize);
 }  // QuickTimeVideo::decodeBlock
 
@@ -586,7 +681,10 @@ static std::string readString(BasicIo& io, size_t size) {
 void QuickTimeVideo::tagDecoder(Exiv2::DataBuf& buf, size_t size) {
   assert(buf.size() > 4);
 
-  if (ignoreList(buf))
+  if (currentStream_ == TimedMetadata && sampleTableList(buf))
+    sampleTableDecoder(buf, size);
+
+  else if (ignoreList(buf))
     discard(size);
 
   else if (dataIgnoreList(buf)) {
@@ -635,26 +733,26 @@ void QuickTimeVideo::tagDecoder(Exiv2::DataBuf& buf, size_t size) {
 
   else if (equalsQTimeTag(buf, "url ")) {
     if (currentStream_ == Video)
-      xmpData_["Xmp.video.URL"] = readString(*io_, size);
+      xmp_["Xmp.video.URL"] = readString(*io_, size);
     else if (currentStream_ == Audio)
-      xmpData_["Xmp.audio.URL"] = readString(*io_, size);
+      xmp_["Xmp.audio.URL"] = readString(*io_, size);
   }
 
   else if (equalsQTimeTag(buf, "urn ")) {
     if (currentStream_ == Video)
-      xmpData_["Xmp.video.URN"] = readString(*io_, size);
+      xmp_["Xmp.video.URN"] = readString(*io_, size);
     else if (currentStream_ == Audio)
-      xmpData_["Xmp.audio.URN"] = readString(*io_, size);
+      xmp_["Xmp.audio.URN"] = readString(*io_, size);
   }
 
   else if (equalsQTimeTag(buf, "dcom")) {
-    xmpData_["Xmp.video.Compressor"] = readString(*io_, size);
+    xmp_["Xmp.video.Compressor"] = readString(*io_, size);
   }
 
   else if (equalsQTimeTag(buf, "smhd")) {
     io_->readOrThrow(buf.data(), 4);
     io_->readOrThrow(buf.data(), 4);
-    xmpData_["Xmp.audio.Balance"] = buf.read_uint16(0, bigEndian);
+    xmp_["Xmp.audio.Balance"] = buf.read_uint16(0, bigEndian);
   }
 
   else {
@@ -671,15 +769,15 @@ void QuickTimeVideo::previewTagDecoder(size_t size) {
   DataBuf buf(4);
   size_t cur_pos = io_->tell();
   io_->readOrThrow(buf.data(), 4);
-  xmpData_["Xmp.video.PreviewDate"] = buf.read_uint32(0, bigEndian);
+  xmp_["Xmp.video.PreviewDate"] = buf.read_uint32(0, bigEndian);
   io_->readOrThrow(buf.data(), 2);
-  xmpData_["Xmp.video.PreviewVersion"] = getShort(buf.data(), bigEndian);
+  xmp_["Xmp.video.PreviewVersion"] = getShort(buf.data(), bigEndian);
 
   io_->readOrThrow(buf.data(), 4);
   if (equalsQTimeTag(buf, "PICT"))
-    xmpData_["Xmp.video.PreviewAtomType"] = "QuickDraw Picture";
+    xmp_["Xmp.video.PreviewAtomType"] = "QuickDraw Picture";
   else
-    xmpData_["Xmp.video.PreviewAtomType"] = std::string{buf.c_str(), 4};
+    xmp_["Xmp.video.PreviewAtomType"] = std::string{buf.c_str(), 4};
 
   io_->seek(cur_pos + size, BasicIo::beg);
 }  // QuickTimeVideo::previewTagDecoder
@@ -688,15 +786,15 @@ void QuickTimeVideo::keysTagDecoder(size_t size) {
   DataBuf buf(4);
   size_t cur_pos = io_->tell();
   io_->readOrThrow(buf.data(), 4);
-  xmpData_["Xmp.video.PreviewDate"] = buf.read_uint32(0, bigEndian);
+  xmp_["Xmp.video.PreviewDate"] = buf.read_uint32(0, bigEndian);
   io_->readOrThrow(buf.data(), 2);
-  xmpData_["Xmp.video.PreviewVersion"] = getShort(buf.data(), bigEndian);
+  xmp_["Xmp.video.PreviewVersion"] = getShort(buf.data(), bigEndian);
 
   io_->readOrThrow(buf.data(), 4);
   if (equalsQTimeTag(buf, "PICT"))
-    xmpData_["Xmp.video.PreviewAtomType"] = "QuickDraw Picture";
+    xmp_["Xmp.video.PreviewAtomType"] = "QuickDraw Picture";
   else
-    xmpData_["Xmp.video.PreviewAtomType"] = std::string{buf.c_str(), 4};
+    xmp_["Xmp.video.PreviewAtomType"] = std::string{buf.c_str(), 4};
 
   io_->seek(cur_pos + size, BasicIo::beg);
 }  // QuickTimeVideo::keysTagDecoder
@@ -714,11 +812,11 @@ void QuickTimeVideo::trackApertureTagDecoder(size_t size) {
       io_->seek(static_cast<long>(4), BasicIo::cur);
       io_->readOrThrow(buf.data(), 2);
       io_->readOrThrow(buf2.data(), 2);
-      xmpData_["Xmp.video.CleanApertureWidth"] =
+      xmp_["Xmp.video.CleanApertureWidth"] =
           Exiv2::toString(buf.read_uint16(0, bigEndian)) + "." + Exiv2::toString(buf2.read_uint16(0, bigEndian));
       io_->readOrThrow(buf.data(), 2);
       io_->readOrThrow(buf2.data(), 2);
-      xmpData_["Xmp.video.CleanApertureHeight"] =
+      xmp_["Xmp.video.CleanApertureHeight"] =
           Exiv2::toString(buf.read_uint16(0, bigEndian)) + "." + Exiv2::toString(buf2.read_uint16(0, bigEndian));
     }
 
@@ -726,11 +824,11 @@ void QuickTimeVideo::trackApertureTagDecoder(size_t size) {
       io_->seek(static_cast<long>(4), BasicIo::cur);
       io_->readOrThrow(buf.data(), 2);
       io_->readOrThrow(buf2.data(), 2);
-      xmpData_["Xmp.video.ProductionApertureWidth"] =
+      xmp_["Xmp.video.ProductionApertureWidth"] =
           Exiv2::toString(buf.read_uint16(0, bigEndian)) + "." + Exiv2::toString(buf2.read_uint16(0, bigEndian));
       io_->readOrThrow(buf.data(), 2);
       io_->readOrThrow(buf2.data(), 2);
-      xmpData_["Xmp.video.ProductionApertureHeight"] =
+      xmp_["Xmp.video.ProductionApertureHeight"] =
           Exiv2::toString(buf.read_uint16(0, bigEndian)) + "." + Exiv2::toString(buf2.read_uint16(0, bigEndian));
     }
 
@@ -738,11 +836,11 @@ void QuickTimeVideo::trackApertureTagDecoder(size_t size) {
       io_->seek(static_cast<long>(4), BasicIo::cur);
       io_->readOrThrow(buf.data(), 2);
       io_->readOrThrow(buf2.data(), 2);
-      xmpData_["Xmp.video.EncodedPixelsWidth"] =
+      xmp_["Xmp.video.EncodedPixelsWidth"] =
           Exiv2::toString(buf.read_uint16(0, bigEndian)) + "." + Exiv2::toString(buf2.read_uint16(0, bigEndian));
       io_->readOrThrow(buf.data(), 2);
       io_->readOrThrow(buf2.data(), 2);
-      xmpData_["Xmp.video.EncodedPixelsHeight"] =
+      xmp_["Xmp.video.EncodedPixelsHeight"] =
           Exiv2::toString(buf.read_uint16(0, bigEndian)) + "." + Exiv2::toString(buf2.read_uint16(0, bigEndian));
     }
   }
@@ -759,35 +857,35 @@ void QuickTimeVideo::CameraTagsDecoder(size_t size_external) {
     io_->seek(cur_pos, BasicIo::beg);
 
     io_->readOrThrow(buf.data(), 24);
-    xmpData_["Xmp.video.Make"] = Exiv2::toString(buf.data());
+    xmp_["Xmp.video.Make"] = Exiv2::toString(buf.data());
     io_->readOrThrow(buf.data(), 14);
-    xmpData_["Xmp.video.Model"] = Exiv2::toString(buf.data());
+    xmp_["Xmp.video.Model"] = Exiv2::toString(buf.data());
     io_->readOrThrow(buf.data(), 4);
-    xmpData_["Xmp.video.ExposureTime"] =
+    xmp_["Xmp.video.ExposureTime"] =
         "1/" + Exiv2::toString(ceil(buf.read_uint32(0, littleEndian) / static_cast<double>(10)));
     io_->readOrThrow(buf.data(), 4);
     io_->readOrThrow(buf2.data(), 4);
-    xmpData_["Xmp.video.FNumber"] =
+    xmp_["Xmp.video.FNumber"] =
         buf.read_uint32(0, littleEndian) / static_cast<double>(buf2.read_uint32(0, littleEndian));
     io_->readOrThrow(buf.data(), 4);
     io_->readOrThrow(buf2.data(), 4);
-    xmpData_["Xmp.video.ExposureCompensation"] =
+    xmp_["Xmp.video.ExposureCompensation"] =
         buf.read_uint32(0, littleEndian) / static_cast<double>(buf2.read_uint32(0, littleEndian));
     io_->readOrThrow(buf.data(), 10);
     io_->readOrThrow(buf.data(), 4);
     td = find(whiteBalance, buf.read_uint32(0, littleEndian));
     if (td)
-      xmpData_["Xmp.video.WhiteBalance"] = exvGettext(td->label_);
+      xmp_["Xmp.video.WhiteBalance"] = exvGettext(td->label_);
     io_->readOrThrow(buf.data(), 4);
     io_->readOrThrow(buf2.data(), 4);
-    xmpData_["Xmp.video.FocalLength"] =
+    xmp_["Xmp.video.FocalLength"] =
         buf.read_uint32(0, littleEndian) / static_cast<double>(buf2.read_uint32(0, littleEndian));
     io_->seek(static_cast<long>(95), BasicIo::cur);
     io_->readOrThrow(buf.data(), 48);
     buf.write_uint8(48, 0);
-    xmpData_["Xmp.video.Software"] = Exiv2::toString(buf.data());
+    xmp_["Xmp.video.Software"] = Exiv2::toString(buf.data());
     io_->readOrThrow(buf.data(), 4);
-    xmpData_["Xmp.video.ISO"] = buf.read_uint32(0, littleEndian);
+    xmp_["Xmp.video.ISO"] = buf.read_uint32(0, littleEndian);
   }
 
   io_->seek(cur_pos + size_external, BasicIo::beg);
@@ -833,7 +931,7 @@ void QuickTimeVideo::userDataDecoder(size_t size_external) {
     else if (equalsQTimeTag(buf, "CNCV") || equalsQTimeTag(buf, "CNFV") || equalsQTimeTag(buf, "CNMN") ||
              equalsQTimeTag(buf, "NCHD") || equalsQTimeTag(buf, "FFMV")) {
       enforce(tv, Exiv2::ErrorCode::kerCorruptedMetadata);
-      xmpData_[exvGettext(tv->label_)] = readString(*io_, size - 8);
+      xmp_[exvGettext(tv->label_)] = readString(*io_, size - 8);
     }
 
     else if (equalsQTimeTag(buf, "CMbo") || equalsQTimeTag(buf, "Cmbo")) {
@@ -843,14 +941,14 @@ void QuickTimeVideo::userDataDecoder(size_t size_external) {
       tv_internal = find(cameraByteOrderTags, Exiv2::toString(buf.data()));
 
       if (tv_internal)
-        xmpData_[exvGettext(tv->label_)] = exvGettext(tv_internal->label_);
+        xmp_[exvGettext(tv->label_)] = exvGettext(tv_internal->label_);
       else
-        xmpData_[exvGettext(tv->label_)] = Exiv2::toString(buf.data());
+        xmp_[exvGettext(tv->label_)] = Exiv2::toString(buf.data());
     }
 
     else if (tv) {
       io_->readOrThrow(buf.data(), 4);
-      xmpData_[exvGettext(tv->label_)] = readString(*io_, size - 12);
+      xmp_[exvGettext(tv->label_)] = readString(*io_, size - 12);
     }
 
     else if (td)
@@ -884,73 +982,73 @@ void QuickTimeVideo::NikonTagsDecoder(size_t size_external) {
       std::memset(buf.data(), 0x0, buf.size());
 
       io_->readOrThrow(buf.data(), 4);
-      xmpData_["Xmp.video.PictureControlVersion"] = Exiv2::toString(buf.data());
+      xmp_["Xmp.video.PictureControlVersion"] = Exiv2::toString(buf.data());
       io_->readOrThrow(buf.data(), 20);
-      xmpData_["Xmp.video.PictureControlName"] = Exiv2::toString(buf.data());
+      xmp_["Xmp.video.PictureControlName"] = Exiv2::toString(buf.data());
       io_->readOrThrow(buf.data(), 20);
-      xmpData_["Xmp.video.PictureControlBase"] = Exiv2::toString(buf.data());
+      xmp_["Xmp.video.PictureControlBase"] = Exiv2::toString(buf.data());
       io_->readOrThrow(buf.data(), 4);
       std::memset(buf.data(), 0x0, buf.size());
 
       io_->readOrThrow(buf.data(), 1);
       td2 = find(PictureControlAdjust, static_cast<int>(buf.data()[0]) & 7);
       if (td2)
-        xmpData_["Xmp.video.PictureControlAdjust"] = exvGettext(td2->label_);
+        xmp_["Xmp.video.PictureControlAdjust"] = exvGettext(td2->label_);
       else
-        xmpData_["Xmp.video.PictureControlAdjust"] = static_cast<int>(buf.data()[0]) & 7;
+        xmp_["Xmp.video.PictureControlAdjust"] = static_cast<int>(buf.data()[0]) & 7;
 
       io_->readOrThrow(buf.data(), 1);
       td2 = find(NormalSoftHard, static_cast<int>(buf.data()[0]) & 7);
       if (td2)
-        xmpData_["Xmp.video.PictureControlQuickAdjust"] = exvGettext(td2->label_);
+        xmp_["Xmp.video.PictureControlQuickAdjust"] = exvGettext(td2->label_);
 
       io_->readOrThrow(buf.data(), 1);
       td2 = find(NormalSoftHard, static_cast<int>(buf.data()[0]) & 7);
       if (td2)
-        xmpData_["Xmp.video.Sharpness"] = exvGettext(td2->label_);
+        xmp_["Xmp.video.Sharpness"] = exvGettext(td2->label_);
       else
-        xmpData_["Xmp.video.Sharpness"] = static_cast<int>(buf.data()[0]) & 7;
+        xmp_["Xmp.video.Sharpness"] = static_cast<int>(buf.data()[0]) & 7;
 
       io_->readOrThrow(buf.data(), 1);
       td2 = find(NormalSoftHard, static_cast<int>(buf.data()[0]) & 7);
       if (td2)
-        xmpData_["Xmp.video.Contrast"] = exvGettext(td2->label_);
+        xmp_["Xmp.video.Contrast"] = exvGettext(td2->label_);
       else
-        xmpData_["Xmp.video.Contrast"] = static_cast<int>(buf.data()[0]) & 7;
+        xmp_["Xmp.video.Contrast"] = static_cast<int>(buf.data()[0]) & 7;
 
       io_->readOrThrow(buf.data(), 1);
       td2 = find(NormalSoftHard, static_cast<int>(buf.data()[0]) & 7);
       if (td2)
-        xmpData_["Xmp.video.Brightness"] = exvGettext(td2->label_);
+        xmp_["Xmp.video.Brightness"] = exvGettext(td2->label_);
       else
-        xmpData_["Xmp.video.Brightness"] = static_cast<int>(buf.data()[0]) & 7;
+        xmp_["Xmp.video.Brightness"] = static_cast<int>(buf.data()[0]) & 7;
 
       io_->readOrThrow(buf.data(), 1);
       td2 = find(Saturation, static_cast<int>(buf.data()[0]) & 7);
       if (td2)
-        xmpData_["Xmp.video.Saturation"] = exvGettext(td2->label_);
+        xmp_["Xmp.video.Saturation"] = exvGettext(td2->label_);
       else
-        xmpData_["Xmp.video.Saturation"] = static_cast<int>(buf.data()[0]) & 7;
+        xmp_["Xmp.video.Saturation"] = static_cast<int>(buf.data()[0]) & 7;
 
       io_->readOrThrow(buf.data(), 1);
-      xmpData_["Xmp.video.HueAdjustment"] = static_cast<int>(buf.data()[0]) & 7;
+      xmp_["Xmp.video.HueAdjustment"] = static_cast<int>(buf.data()[0]) & 7;
 
       io_->readOrThrow(buf.data(), 1);
       td2 = find(FilterEffect, static_cast<int>(buf.data()[0]));
       if (td2)
-        xmpData_["Xmp.video.FilterEffect"] = exvGettext(td2->label_);
+        xmp_["Xmp.video.FilterEffect"] = exvGettext(td2->label_);
       else
-        xmpData_["Xmp.video.FilterEffect"] = static_cast<int>(buf.data()[0]);
+        xmp_["Xmp.video.FilterEffect"] = static_cast<int>(buf.data()[0]);
 
       io_->readOrThrow(buf.data(), 1);
       td2 = find(ToningEffect, static_cast<int>(buf.data()[0]));
       if (td2)
-        xmpData_["Xmp.video.ToningEffect"] = exvGettext(td2->label_);
+        xmp_["Xmp.video.ToningEffect"] = exvGettext(td2->label_);
       else
-        xmpData_["Xmp.video.ToningEffect"] = static_cast<int>(buf.data()[0]);
+        xmp_["Xmp.video.ToningEffect"] = static_cast<int>(buf.data()[0]);
 
       io_->readOrThrow(buf.data(), 1);
-      xmpData_["Xmp.video.ToningSaturation"] = static_cast<int>(buf.data()[0]);
+      xmp_["Xmp.video.ToningSaturation"] = static_cast<int>(buf.data()[0]);
 
       io_->seek(local_pos + dataLength, BasicIo::beg);
     }
@@ -961,16 +1059,16 @@ void QuickTimeVideo::NikonTagsDecoder(size_t size_external) {
       std::memset(buf.data(), 0x0, buf.size());
 
       io_->readOrThrow(buf.data(), 2);
-      xmpData_["Xmp.video.TimeZone"] = Exiv2::getShort(buf.data(), bigEndian);
+      xmp_["Xmp.video.TimeZone"] = Exiv2::getShort(buf.data(), bigEndian);
       io_->readOrThrow(buf.data(), 1);
       td2 = find(YesNo, static_cast<int>(buf.data()[0]));
       if (td2)
-        xmpData_["Xmp.video.DayLightSavings"] = exvGettext(td2->label_);
+        xmp_["Xmp.video.DayLightSavings"] = exvGettext(td2->label_);
 
       io_->readOrThrow(buf.data(), 1);
       td2 = find(DateDisplayFormat, static_cast<int>(buf.data()[0]));
       if (td2)
-        xmpData_["Xmp.video.DateDisplayFormat"] = exvGettext(td2->label_);
+        xmp_["Xmp.video.DateDisplayFormat"] = exvGettext(td2->label_);
 
       io_->seek(local_pos + dataLength, BasicIo::beg);
     }
@@ -991,14 +1089,14 @@ void QuickTimeVideo::NikonTagsDecoder(size_t size_external) {
       }
 
       if (td) {
-        xmpData_[exvGettext(td->label_)] = Exiv2::toString(buf.data());
+        xmp_[exvGettext(td->label_)] = Exiv2::toString(buf.data());
       }
     } else if (dataType == 4) {
       dataLength = buf.read_uint16(0, bigEndian) * 4;
       std::memset(buf.data(), 0x0, buf.size());
       io_->readOrThrow(buf.data(), 4);
       if (td)
-        xmpData_[exvGettext(td->label_)] = Exiv2::toString(buf.read_uint32(0, bigEndian));
+        xmp_[exvGettext(td->label_)] = Exiv2::toString(buf.read_uint32(0, bigEndian));
 
       // Sanity check with an "unreasonably" large number
       if (dataLength > 200 || dataLength < 4) {
@@ -1014,7 +1112,7 @@ void QuickTimeVideo::NikonTagsDecoder(size_t size_external) {
       std::memset(buf.data(), 0x0, buf.size());
       io_->readOrThrow(buf.data(), 2);
       if (td)
-        xmpData_[exvGettext(td->label_)] = Exiv2::toString(buf.read_uint16(0, bigEndian));
+        xmp_[exvGettext(td->label_)] = Exiv2::toString(buf.read_uint16(0, bigEndian));
 
       // Sanity check with an "unreasonably" large number
       if (dataLength > 200 || dataLength < 2) {
@@ -1031,7 +1129,7 @@ void QuickTimeVideo::NikonTagsDecoder(size_t size_external) {
       io_->readOrThrow(buf.data(), 4);
       io_->readOrThrow(buf2.data(), 4);
       if (td)
-        xmpData_[exvGettext(td->label_)] = Exiv2::toString(static_cast<double>(buf.read_uint32(0, bigEndian)) /
+        xmp_[exvGettext(td->label_)] = Exiv2::toString(static_cast<double>(buf.read_uint32(0, bigEndian)) /
                                                            static_cast<double>(buf2.read_uint32(0, bigEndian)));
 
       // Sanity check with an "unreasonably" large number
@@ -1049,7 +1147,7 @@ void QuickTimeVideo::NikonTagsDecoder(size_t size_external) {
       io_->readOrThrow(buf.data(), 2);
       io_->readOrThrow(buf2.data(), 2);
       if (td)
-        xmpData_[exvGettext(td->label_)] =
+        xmp_[exvGettext(td->label_)] =
             Exiv2::toString(buf.read_uint16(0, bigEndian)) + " " + Exiv2::toString(buf2.read_uint16(0, bigEndian));
 
       // Sanity check with an "unreasonably" large number
@@ -1068,6 +1166,8 @@ void QuickTimeVideo::NikonTagsDecoder(size_t size_external) {
 }  // QuickTimeVideo::NikonTagsDecoder
 
 void QuickTimeVideo::setMediaStream() {
+  addTimedMetadataTrack();
+
   size_t current_position = io_->tell();
   DataBuf buf(4 + 1);
 
@@ -1084,6 +1184,8 @@ void QuickTimeVideo::setMediaStream() {
         currentStream_ = Audio;
       else if (equalsQTimeTag(buf, "hint"))
         currentStream_ = Hint;
+      else if (equalsQTimeTag(buf, "meta") || equalsQTimeTag(buf, "camm"))
+        currentStream_ = TimedMetadata;
       else
         currentStream_ = GenMediaHeader;
       break;
@@ -1102,16 +1204,159 @@ void QuickTimeVideo::timeToSampleDecoder() {
 
   for (uint32_t i = 0; i < noOfEntries; i++) {
     io_->readOrThrow(buf.data(), 4);
-    const uint64_t temp = buf.read_uint32(0, bigEndian);
-    totalframes = Safe::add(totalframes, temp);
+    const uint32_t temp = buf.read_uint32(0, bigEndian);
+    totalframes = Safe::add(totalframes, static_cast<uint64_t>(temp));
     io_->readOrThrow(buf.data(), 4);
-    timeOfFrames = Safe::add(timeOfFrames, temp * buf.read_uint32(0, bigEndian));
+    const uint32_t delta = buf.read_uint32(0, bigEndian);
+    timeOfFrames = Safe::add(timeOfFrames, static_cast<uint64_t>(temp) * delta);
+    if (currentStream_ == TimedMetadata)
+      sampleTable_.timeToSample_.emplace_back(temp, delta);
   }
   if (currentStream_ == Video)
-    xmpData_["Xmp.video.FrameRate"] =
+    xmp_["Xmp.video.FrameRate"] =
         static_cast<double>(totalframes) * static_cast<double>(timeScale_) / static_cast<double>(timeOfFrames);
 }  // QuickTimeVideo::timeToSampleDecoder
 
+void QuickTimeVideo::sampleTableDecoder(Exiv2::DataBuf& buf, size_t size) {
+  DataBuf data(size);
+  io_->readOrThrow(data.data(), size, ErrorCode::kerCorruptedMetadata);
+
+  // Version and flags, followed by the number of entries
+  enforce(size >= 8, ErrorCode::kerCorruptedMetadata);
+  if (equalsQTimeTag(buf, "stsz")) {
+    enforce(size >= 12, ErrorCode::kerCorruptedMetadata);
+    sampleTable_.sampleSize_ = data.read_uint32(4, bigEndian);
+    sampleTable_.sampleCount_ = data.read_uint32(8, bigEndian);
+    if (sampleTable_.sampleSize_ == 0) {
+      enforce(sampleTable_.sampleCount_ <= (size - 12) / 4, ErrorCode::kerCorruptedMetadata);
+      sampleTable_.sampleSizes_.resize(sampleTable_.sampleCount_);
+      for (size_t i = 0; i < sampleTable_.sampleCount_; ++i)
+        sampleTable_.sampleSizes_[i] = data.read_uint32(12 + 4 * i, bigEndian);
+    } else {
+      enforce(static_cast<uint64_t>(sampleTable_.sampleSize_) * sampleTable_.sampleCount_ <= io_->size(),
+              ErrorCode::kerCorruptedMetadata);
+    }
+    return;
+  }
+
+  const uint32_t noOfEntries = data.read_uint32(4, bigEndian);
+  if (equalsQTimeTag(buf, "stsc")) {
+    enforce(noOfEntries <= (size - 8) / 12, ErrorCode::kerCorruptedMetadata);
+    for (size_t i = 0; i < noOfEntries; ++i)
+      sampleTable_.sampleToChunk_.push_back({data.read_uint32(8 + 12 * i, bigEndian),
+                                             data.read_uint32(12 + 12 * i, bigEndian)});
+  } else if (equalsQTimeTag(buf, "stco")) {
+    enforce(noOfEntries <= (size - 8) / 4, ErrorCode::kerCorruptedMetadata);
+    for (size_t i = 0; i < noOfEntries; ++i)
+      sampleTable_.chunkOffsets_.push_back(data.read_uint32(8 + 4 * i, bigEndian));
+  } else {
+    enforce(noOfEntries <= (size - 8) / 8, ErrorCode::kerCorruptedMetadata);
+    for (size_t i = 0; i < noOfEntries; ++i)
+      sampleTable_.chunkOffsets_.push_back(data.read_uint64(8 + 8 * i, bigEndian));
+  }
+}  // QuickTimeVideo::sampleTableDecoder
+
+void QuickTimeVideo::addTimedMetadataTrack() {
+  const SampleTable table = std::move(sampleTable_);
+  sampleTable_ = SampleTable();
+  if (currentStream_ != TimedMetadata || table.sampleToChunk_.empty())
+    return;
+
+  TimedMetadataTrack track;
+  track.format_ = table.format_;
+  const auto timeScale = static_cast<double>(table.timeScale_ ? table.timeScale_ : 1);
+  auto stts = table.timeToSample_.begin();
+  uint32_t sttsLeft = stts != table.timeToSample_.end() ? stts->first : 0;
+  auto stsc = table.sampleToChunk_.begin();
+  uint64_t time = 0;
+  size_t sample = 0;
+
+  for (size_t chunk = 0; chunk < table.chunkOffsets_.size() && sample < table.sampleCount_; ++chunk) {
+    // Sample to chunk entries apply from their (1-based) first chunk on
+    while (std::next(stsc) != table.sampleToChunk_.end() && (*std::next(stsc))[0] <= chunk + 1)
+      ++stsc;
+    uint64_t offset = table.chunkOffsets_[chunk];
+    for (uint32_t i = 0; i < (*stsc)[1] && sample < table.sampleCount_; ++i, ++sample) {
+      const uint32_t size = table.sampleSizes_.empty() ? table.sampleSize_ : table.sampleSizes_[sample];
+      if (offset > io_->size() || size > io_->size() - offset)
+        break;
+      while (sttsLeft == 0 && stts != table.timeToSample_.end() && ++stts != table.timeToSample_.end())
+        sttsLeft = stts->first;
+      uint32_t duration = 0;
+      if (sttsLeft != 0) {
+        duration = stts->second;
+        --sttsLeft;
+      }
+      track.samples_.push_back({offset, size, static_cast<double>(time) / timeScale, duration / timeScale});
+      offset += size;
+      time += duration;
+    }
+  }
+
+  if (!track.samples_.empty())
+    timedMetadataTracks_.push_back(std::move(track));
+}  // QuickTimeVideo::addTimedMetadataTrack
+
+std::vector<DataBuf> QuickTimeVideo::readSamples(const TimedMetadataTrack& track, size_t first, size_t count) {
+  const auto& samples = track.samples_;
+  enforce(first <= samples.size() && count <= samples.size() - first, ErrorCode::kerOffsetOutOfRange);
+
+  if (io_->open() != 0)
+    throw Error(ErrorCode::kerDataSourceOpenFailed, io_->path(), strError());
+  IoCloser closer(*io_);
+
+  std::vector<DataBuf> result;
+  result.reserve(count);
+  DataBuf run;
+  for (size_t i = first; i < first + count;) {
+    // Fetch samples which directly follow each other with one read
+    size_t end = i + 1;
+    size_t runSize = samples[i].size_;
+    while (end < first + count && samples[end].offset_ == samples[end - 1].offset_ + samples[end - 1].size_ &&
+           samples[end].size_ <= maxSampleRunSize - std::min(runSize, maxSampleRunSize)) {
+      runSize += samples[end].size_;
+      ++end;
+    }
+    enforce(samples[i].offset_ <= io_->size() && runSize <= io_->size() - samples[i].offset_,
+            ErrorCode::kerCorruptedMetadata);
+    run.alloc(runSize);
+    io_->seek(static_cast<int64_t>(samples[i].offset_), BasicIo::beg);
+    io_->readOrThrow(run.data(), runSize, ErrorCode::kerCorruptedMetadata);
+
+    size_t pos = 0;
+    for (; i < end; ++i) {
+      result.emplace_back(samples[i].size_ ? run.c_data(pos) : nullptr, samples[i].size_);
+      pos += samples[i].size_;
+    }
+  }
+  return result;
+}  // QuickTimeVideo::readSamples
+
+std::vector<GpsPoint> QuickTimeVideo::gpsTrack() {
+  std::vector<GpsPoint> gps;
+  for (const auto& track : timedMetadataTracks_) {
+    const bool gpmf = track.format_ == "gpmd";
+    if (!gpmf && track.format_ != "camm")
+      continue;
+
+    for (size_t first = 0; first < track.samples_.size(); first += gpsSampleBatchSize) {
+      const size_t count = std::min(gpsSampleBatchSize, track.samples_.size() - first);
+      const auto data = readSamples(track, first, count);
+      for (size_t i = 0; i < count; ++i) {
+        if (gpmf)
+          decodeGpmfGps(data[i].c_data(), data[i].size(), track.samples_[first + i], gps);
+        else
+          decodeCammGps(data[i].c_data(), data[i].size(), track.samples_[first + i], gps);
+      }
+    }
+  }
+  return gps;
+}  // QuickTimeVideo::gpsTrack
+
+const std::vector<TimedMetadataTrack>& QuickTimeVideo::timedMetadataTracks() const {
+  return timedMetadataTracks_;
+}
+
 void QuickTimeVideo::sampleDesc(size_t size) {
   DataBuf buf(100);
   size_t cur_pos = io_->tell();
@@ -1124,7 +1369,12 @@ void QuickTimeVideo::sampleDesc(size_t size) {
       imageDescDecoder();
     else if (currentStream_ == Audio)
       audioDescDecoder();
-    else
+    else if (currentStream_ == TimedMetadata) {
+      // Size and format of the first sample entry
+      io_->readOrThrow(buf.data(), 8);
+      sampleTable_.format_ = std::string(buf.c_str(4), 4);
+      break;
+    } else
       break;
   }
   io_->seek(Safe::add(cur_pos, size), BasicIo::beg);
@@ -1145,22 +1395,21 @@ void QuickTimeVideo::audioDescDecoder() {
       case AudioFormat:
         td = find(qTimeFileType, Exiv2::toString(buf.data()));
         if (td)
-          xmpData_["Xmp.audio.Compressor"] = exvGettext(td->label_);
+          xmp_["Xmp.audio.Compressor"] = exvGettext(td->label_);
         else
-          xmpData_["Xmp.audio.Compressor"] = Exiv2::toString(buf.data());
+          xmp_["Xmp.audio.Compressor"] = Exiv2::toString(buf.data());
         break;
       case AudioVendorID:
         td = find(vendorIDTags, Exiv2::toString(buf.data()));
         if (td)
-          xmpData_["Xmp.audio.VendorID"] = exvGettext(td->label_);
+          xmp_["Xmp.audio.VendorID"] = exvGettext(td->label_);
         break;
       case AudioChannels:
-        xmpData_["Xmp.audio.ChannelType"] = buf.read_uint16(0, bigEndian);
-        xmpData_["Xmp.audio.BitsPerSample"] = (buf.data()[2] * 256 + buf.data()[3]);
+        xmp_["Xmp.audio.ChannelType"] = buf.read_uint16(0, bigEndian);
+        xmp_["Xmp.audio.BitsPerSample"] = (buf.data()[2] * 256 + buf.data()[3]);
         break;
       case AudioSampleRate:
-        xmpData_["Xmp.audio.SampleRate"] =
-            buf.read_uint16(0, bigEndian) + ((buf.data()[2] * 256 + buf.data()[3]) * 0.01);
+        xmp_["Xmp.audio.SampleRate"] = buf.read_uint16(0, bigEndian) + ((buf.data()[2] * 256 + buf.data()[3]) * 0.01);
         break;
       default:
         break;
@@ -1185,40 +1434,38 @@ void QuickTimeVideo::imageDescDecoder() {
       case codec:
         td = find(qTimeFileType, Exiv2::toString(buf.data()));
         if (td)
-          xmpData_["Xmp.video.Codec"] = exvGettext(td->label_);
+          xmp_["Xmp.video.Codec"] = exvGettext(td->label_);
         else
-          xmpData_["Xmp.video.Codec"] = Exiv2::toString(buf.data());
+          xmp_["Xmp.video.Codec"] = Exiv2::toString(buf.data());
         break;
       case VendorID:
         td = find(vendorIDTags, Exiv2::toString(buf.data()));
         if (td)
-          xmpData_["Xmp.video.VendorID"] = exvGettext(td->label_);
+          xmp_["Xmp.video.VendorID"] = exvGettext(td->label_);
         break;
       case SourceImageWidth_Height:
-        xmpData_["Xmp.video.SourceImageWidth"] = buf.read_uint16(0, bigEndian);
-        xmpData_["Xmp.video.SourceImageHeight"] = (buf.data()[2] * 256 + buf.data()[3]);
+        xmp_["Xmp.video.SourceImageWidth"] = buf.read_uint16(0, bigEndian);
+        xmp_["Xmp.video.SourceImageHeight"] = (buf.data()[2] * 256 + buf.data()[3]);
         break;
       case XResolution:
-        xmpData_["Xmp.video.XResolution"] =
-            buf.read_uint16(0, bigEndian) + ((buf.data()[2] * 256 + buf.data()[3]) * 0.01);
+        xmp_["Xmp.video.XResolution"] = buf.read_uint16(0, bigEndian) + ((buf.data()[2] * 256 + buf.data()[3]) * 0.01);
         break;
       case YResolution:
-        xmpData_["Xmp.video.YResolution"] =
-            buf.read_uint16(0, bigEndian) + ((buf.data()[2] * 256 + buf.data()[3]) * 0.01);
+        xmp_["Xmp.video.YResolution"] = buf.read_uint16(0, bigEndian) + ((buf.data()[2] * 256 + buf.data()[3]) * 0.01);
         io_->readOrThrow(buf.data(), 3);
         size -= 3;
         break;
       case CompressorName:
         io_->readOrThrow(buf.data(), 32);
         size -= 32;
-        xmpData_["Xmp.video.Compressor"] = Exiv2::toString(buf.data());
+        xmp_["Xmp.video.Compressor"] = Exiv2::toString(buf.data());
         break;
       default:
         break;
     }
   }
   io_->readOrThrow(buf.data(), static_cast<long>(size % 4));
-  xmpData_["Xmp.video.BitDepth"] = static_cast<int>(buf.read_uint8(0));
+  xmp_["Xmp.video.BitDepth"] = static_cast<int>(buf.read_uint8(0));
 }  // QuickTimeVideo::imageDescDecoder
 
 void QuickTimeVideo::multipleEntriesDecoder() {
@@ -1249,10 +1496,10 @@ void QuickTimeVideo::videoHeaderDecoder(size_t size) {
       case GraphicsMode:
         td = find(graphicsModetags, buf.read_uint16(0, bigEndian));
         if (td)
-          xmpData_["Xmp.video.GraphicsMode"] = exvGettext(td->label_);
+          xmp_["Xmp.video.GraphicsMode"] = exvGettext(td->label_);
         break;
       case OpColor:
-        xmpData_["Xmp.video.OpColor"] = buf.read_uint16(0, bigEndian);
+        xmp_["Xmp.video.OpColor"] = buf.read_uint16(0, bigEndian);
         break;
       default:
         break;
@@ -1277,27 +1524,27 @@ void QuickTimeVideo::handlerDecoder(size_t size) {
         tv = find(handlerClassTags, Exiv2::toString(buf.data()));
         if (tv) {
           if (currentStream_ == Video)
-            xmpData_["Xmp.video.HandlerClass"] = exvGettext(tv->label_);
+            xmp_["Xmp.video.HandlerClass"] = exvGettext(tv->label_);
           else if (currentStream_ == Audio)
-            xmpData_["Xmp.audio.HandlerClass"] = exvGettext(tv->label_);
+            xmp_["Xmp.audio.HandlerClass"] = exvGettext(tv->label_);
         }
         break;
       case HandlerType:
         tv = find(handlerTypeTags, Exiv2::toString(buf.data()));
         if (tv) {
           if (currentStream_ == Video)
-            xmpData_["Xmp.video.HandlerType"] = exvGettext(tv->label_);
+            xmp_["Xmp.video.HandlerType"] = exvGettext(tv->label_);
           else if (currentStream_ == Audio)
-            xmpData_["Xmp.audio.HandlerType"] = exvGettext(tv->label_);
+            xmp_["Xmp.audio.HandlerType"] = exvGettext(tv->label_);
         }
         break;
       case HandlerVendorID:
         tv = find(vendorIDTags, Exiv2::toString(buf.data()));
         if (tv) {
           if (currentStream_ == Video)
-            xmpData_["Xmp.video.HandlerVendorID"] = exvGettext(tv->label_);
+            xmp_["Xmp.video.HandlerVendorID"] = exvGettext(tv->label_);
           else if (currentStream_ == Audio)
-            xmpData_["Xmp.audio.HandlerVendorID"] = exvGettext(tv->label_);
+            xmp_["Xmp.audio.HandlerVendorID"] = exvGettext(tv->label_);
         }
         break;
     }
@@ -1319,10 +1566,10 @@ void QuickTimeVideo::fileTypeDecoder(size_t size) {
     switch (i) {
       case 0:
         if (td)
-          xmpData_["Xmp.video.MajorBrand"] = exvGettext(td->label_);
+          xmp_["Xmp.video.MajorBrand"] = exvGettext(td->label_);
         break;
       case 1:
-        xmpData_["Xmp.video.MinorVersion"] = buf.read_uint32(0, bigEndian);
+        xmp_["Xmp.video.MinorVersion"] = buf.read_uint32(0, bigEndian);
         break;
       default:
         if (td)
@@ -1348,44 +1595,46 @@ void QuickTimeVideo::mediaHeaderDecoder(size_t size) {
     switch (i) {
       case MediaHeaderVersion:
         if (currentStream_ == Video)
-          xmpData_["Xmp.video.MediaHeaderVersion"] = static_cast<int>(buf.read_uint8(0));
+          xmp_["Xmp.video.MediaHeaderVersion"] = static_cast<int>(buf.read_uint8(0));
         else if (currentStream_ == Audio)
-          xmpData_["Xmp.audio.MediaHeaderVersion"] = static_cast<int>(buf.read_uint8(0));
+          xmp_["Xmp.audio.MediaHeaderVersion"] = static_cast<int>(buf.read_uint8(0));
         break;
       case MediaCreateDate:
         // A 32-bit integer that specifies (in seconds since midnight, January 1, 1904) when the movie atom was created.
         if (currentStream_ == Video)
-          xmpData_["Xmp.video.MediaCreateDate"] = buf.read_uint32(0, bigEndian);
+          xmp_["Xmp.video.MediaCreateDate"] = buf.read_uint32(0, bigEndian);
         else if (currentStream_ == Audio)
-          xmpData_["Xmp.audio.MediaCreateDate"] = buf.read_uint32(0, bigEndian);
+          xmp_["Xmp.audio.MediaCreateDate"] = buf.read_uint32(0, bigEndian);
         break;
       case MediaModifyDate:
         // A 32-bit integer that specifies (in seconds since midnight, January 1, 1904) when the movie atom was created.
         if (currentStream_ == Video)
-          xmpData_["Xmp.video.MediaModifyDate"] = buf.read_uint32(0, bigEndian);
+          xmp_["Xmp.video.MediaModifyDate"] = buf.read_uint32(0, bigEndian);
         else if (currentStream_ == Audio)
-          xmpData_["Xmp.audio.MediaModifyDate"] = buf.read_uint32(0, bigEndian);
+          xmp_["Xmp.audio.MediaModifyDate"] = buf.read_uint32(0, bigEndian);
         break;
       case MediaTimeScale:
         if (currentStream_ == Video)
-          xmpData_["Xmp.video.MediaTimeScale"] = buf.read_uint32(0, bigEndian);
+          xmp_["Xmp.video.MediaTimeScale"] = buf.read_uint32(0, bigEndian);
         else if (currentStream_ == Audio)
-          xmpData_["Xmp.audio.MediaTimeScale"] = buf.read_uint32(0, bigEndian);
+          xmp_["Xmp.audio.MediaTimeScale"] = buf.read_uint32(0, bigEndian);
         time_scale = buf.read_uint32(0, bigEndian);
         if (time_scale <= 0)
           time_scale = 1;
+        if (currentStream_ == TimedMetadata)
+          sampleTable_.timeScale_ = time_scale;
         break;
       case MediaDuration:
         if (currentStream_ == Video)
-          xmpData_["Xmp.video.MediaDuration"] = time_scale ? buf.read_uint32(0, bigEndian) / time_scale : 0;
+          xmp_["Xmp.video.MediaDuration"] = time_scale ? buf.read_uint32(0, bigEndian) / time_scale : 0;
         else if (currentStream_ == Audio)
-          xmpData_["Xmp.audio.MediaDuration"] = time_scale ? buf.read_uint32(0, bigEndian) / time_scale : 0;
+          xmp_["Xmp.audio.MediaDuration"] = time_scale ? buf.read_uint32(0, bigEndian) / time_scale : 0;
         break;
       case MediaLanguageCode:
         if (currentStream_ == Video)
-          xmpData_["Xmp.video.MediaLangCode"] = buf.read_uint16(0, bigEndian);
+          xmp_["Xmp.video.MediaLangCode"] = buf.read_uint16(0, bigEndian);
         else if (currentStream_ == Audio)
-          xmpData_["Xmp.audio.MediaLangCode"] = buf.read_uint16(0, bigEndian);
+          xmp_["Xmp.audio.MediaLangCode"] = buf.read_uint16(0, bigEndian);
         break;
 
       default:
@@ -1407,59 +1656,59 @@ void QuickTimeVideo::trackHeaderDecoder(size_t size) {
     switch (i) {
       case TrackHeaderVersion:
         if (currentStream_ == Video)
-          xmpData_["Xmp.video.TrackHeaderVersion"] = static_cast<int>(buf.read_uint8(0));
+          xmp_["Xmp.video.TrackHeaderVersion"] = static_cast<int>(buf.read_uint8(0));
         else if (currentStream_ == Audio)
-          xmpData_["Xmp.audio.TrackHeaderVersion"] = static_cast<int>(buf.read_uint8(0));
+          xmp_["Xmp.audio.TrackHeaderVersion"] = static_cast<int>(buf.read_uint8(0));
         break;
       case TrackCreateDate:
         // A 32-bit integer that specifies (in seconds since midnight, January 1, 1904) when the movie atom was created.
         if (currentStream_ == Video)
-          xmpData_["Xmp.video.TrackCreateDate"] = buf.read_uint32(0, bigEndian);
+          xmp_["Xmp.video.TrackCreateDate"] = buf.read_uint32(0, bigEndian);
         else if (currentStream_ == Audio)
-          xmpData_["Xmp.audio.TrackCreateDate"] = buf.read_uint32(0, bigEndian);
+          xmp_["Xmp.audio.TrackCreateDate"] = buf.read_uint32(0, bigEndian);
         break;
       case TrackModifyDate:
         // A 32-bit integer that specifies (in seconds since midnight, January 1, 1904) when the movie atom was created.
         if (currentStream_ == Video)
-          xmpData_["Xmp.video.TrackModifyDate"] = buf.read_uint32(0, bigEndian);
+          xmp_["Xmp.video.TrackModifyDate"] = buf.read_uint32(0, bigEndian);
         else if (currentStream_ == Audio)
-          xmpData_["Xmp.audio.TrackModifyDate"] = buf.read_uint32(0, bigEndian);
+          xmp_["Xmp.audio.TrackModifyDate"] = buf.read_uint32(0, bigEndian);
         break;
       case TrackID:
         if (currentStream_ == Video)
-          xmpData_["Xmp.video.TrackID"] = buf.read_uint32(0, bigEndian);
+          xmp_["Xmp.video.TrackID"] = buf.read_uint32(0, bigEndian);
         else if (currentStream_ == Audio)
-          xmpData_["Xmp.audio.TrackID"] = buf.read_uint32(0, bigEndian);
+          xmp_["Xmp.audio.TrackID"] = buf.read_uint32(0, bigEndian);
         break;
       case TrackDuration:
         if (currentStream_ == Video)
-          xmpData_["Xmp.video.TrackDuration"] = timeScale_ ? buf.read_uint32(0, bigEndian) / timeScale_ : 0;
+          xmp_["Xmp.video.TrackDuration"] = timeScale_ ? buf.read_uint32(0, bigEndian) / timeScale_ : 0;
         else if (currentStream_ == Audio)
-          xmpData_["Xmp.audio.TrackDuration"] = timeScale_ ? buf.read_uint32(0, bigEndian) / timeScale_ : 0;
+          xmp_["Xmp.audio.TrackDuration"] = timeScale_ ? buf.read_uint32(0, bigEndian) / timeScale_ : 0;
         break;
       case TrackLayer:
         if (currentStream_ == Video)
-          xmpData_["Xmp.video.TrackLayer"] = buf.read_uint16(0, bigEndian);
+          xmp_["Xmp.video.TrackLayer"] = buf.read_uint16(0, bigEndian);
         else if (currentStream_ == Audio)
-          xmpData_["Xmp.audio.TrackLayer"] = buf.read_uint16(0, bigEndian);
+          xmp_["Xmp.audio.TrackLayer"] = buf.read_uint16(0, bigEndian);
         break;
       case TrackVolume:
         if (currentStream_ == Video)
-          xmpData_["Xmp.video.TrackVolume"] = (static_cast<int>(buf.read_uint8(0)) + (buf.data()[2] * 0.1)) * 100;
+          xmp_["Xmp.video.TrackVolume"] = (static_cast<int>(buf.read_uint8(0)) + (buf.data()[2] * 0.1)) * 100;
         else if (currentStream_ == Audio)
-          xmpData_["Xmp.video.TrackVolume"] = (static_cast<int>(buf.read_uint8(0)) + (buf.data()[2] * 0.1)) * 100;
+          xmp_["Xmp.video.TrackVolume"] = (static_cast<int>(buf.read_uint8(0)) + (buf.data()[2] * 0.1)) * 100;
         break;
       case ImageWidth:
         if (currentStream_ == Video) {
           temp = buf.read_uint16(0, bigEndian) + static_cast<int64_t>((buf.data()[2] * 256 + buf.data()[3]) * 0.01);
-          xmpData_["Xmp.video.Width"] = temp;
+          xmp_["Xmp.video.Width"] = temp;
           width_ = temp;
         }
         break;
       case ImageHeight:
         if (currentStream_ == Video) {
           temp = buf.read_uint16(0, bigEndian) + static_cast<int64_t>((buf.data()[2] * 256 + buf.data()[3]) * 0.01);
-          xmpData_["Xmp.video.Height"] = temp;
+          xmp_["Xmp.video.Height"] = temp;
           height_ = temp;
         }
         break;
@@ -1480,54 +1729,54 @@ void QuickTimeVideo::movieHeaderDecoder(size_t size) {
 
     switch (i) {
       case MovieHeaderVersion:
-        xmpData_["Xmp.video.MovieHeaderVersion"] = static_cast<int>(buf.read_uint8(0));
+        xmp_["Xmp.video.MovieHeaderVersion"] = static_cast<int>(buf.read_uint8(0));
         break;
       case CreateDate:
         // A 32-bit integer that specifies (in seconds since midnight, January 1, 1904) when the movie atom was created.
-        xmpData_["Xmp.video.DateUTC"] = buf.read_uint32(0, bigEndian);
+        xmp_["Xmp.video.DateUTC"] = buf.read_uint32(0, bigEndian);
         break;
       case ModifyDate:
         // A 32-bit integer that specifies (in seconds since midnight, January 1, 1904) when the movie atom was created.
-        xmpData_["Xmp.video.ModificationDate"] = buf.read_uint32(0, bigEndian);
+        xmp_["Xmp.video.ModificationDate"] = buf.read_uint32(0, bigEndian);
         break;
       case TimeScale:
-        xmpData_["Xmp.video.TimeScale"] = buf.read_uint32(0, bigEndian);
+        xmp_["Xmp.video.TimeScale"] = buf.read_uint32(0, bigEndian);
         timeScale_ = buf.read_uint32(0, bigEndian);
         if (timeScale_ <= 0)
           timeScale_ = 1;
         break;
       case Duration:
         if (timeScale_ != 0) {  // To prevent division by zero
-          xmpData_["Xmp.video.Duration"] = buf.read_uint32(0, bigEndian) * 1000 / timeScale_;
+          xmp_["Xmp.video.Duration"] = buf.read_uint32(0, bigEndian) * 1000 / timeScale_;
         }
         break;
       case PreferredRate:
-        xmpData_["Xmp.video.PreferredRate"] =
+        xmp_["Xmp.video.PreferredRate"] =
             buf.read_uint16(0, bigEndian) + ((buf.data()[2] * 256 + buf.data()[3]) * 0.01);
         break;
       case PreferredVolume:
-        xmpData_["Xmp.video.PreferredVolume"] = (static_cast<int>(buf.read_uint8(0)) + (buf.data()[2] * 0.1)) * 100;
+        xmp_["Xmp.video.PreferredVolume"] = (static_cast<int>(buf.read_uint8(0)) + (buf.data()[2] * 0.1)) * 100;
         break;
       case PreviewTime:
-        xmpData_["Xmp.video.PreviewTime"] = buf.read_uint32(0, bigEndian);
+        xmp_["Xmp.video.PreviewTime"] = buf.read_uint32(0, bigEndian);
         break;
       case PreviewDuration:
-        xmpData_["Xmp.video.PreviewDuration"] = buf.read_uint32(0, bigEndian);
+        xmp_["Xmp.video.PreviewDuration"] = buf.read_uint32(0, bigEndian);
         break;
       case PosterTime:
-        xmpData_["Xmp.video.PosterTime"] = buf.read_uint32(0, bigEndian);
+        xmp_["Xmp.video.PosterTime"] = buf.read_uint32(0, bigEndian);
         break;
       case SelectionTime:
-        xmpData_["Xmp.video.SelectionTime"] = buf.read_uint32(0, bigEndian);
+        xmp_["Xmp.video.SelectionTime"] = buf.read_uint32(0, bigEndian);
         break;
       case SelectionDuration:
-        xmpData_["Xmp.video.SelectionDuration"] = buf.read_uint32(0, bigEndian);
+        xmp_["Xmp.video.SelectionDuration"] = buf.read_uint32(0, bigEndian);
         break;
       case CurrentTime:
-        xmpData_["Xmp.video.CurrentTime"] = buf.read_uint32(0, bigEndian);
+        xmp_["Xmp.video.CurrentTime"] = buf.read_uint32(0, bigEndian);
         break;
       case NextTrackID:
-        xmpData_["Xmp.video.NextTrackID"] = buf.read_uint32(0, bigEndian);
+        xmp_["Xmp.video.NextTrackID"] = buf.read_uint32(0, bigEndian);
         break;
       default:
         break;
@@ -1541,34 +1790,34 @@ void QuickTimeVideo::aspectRatio() {
 
   double aspectRatio = static_cast<double>(width_) / static_cast<double>(height_);
   aspectRatio = floor(aspectRatio * 10) / 10;
-  xmpData_["Xmp.video.AspectRatio"] = aspectRatio;
+  xmp_["Xmp.video.AspectRatio"] = aspectRatio;
 
   auto aR = static_cast<int>((aspectRatio * 10.0) + 0.1);
 
   switch (aR) {
     case 13:
-      xmpData_["Xmp.video.AspectRatio"] = "4:3";
+      xmp_["Xmp.video.AspectRatio"] = "4:3";
       break;
     case 17:
-      xmpData_["Xmp.video.AspectRatio"] = "16:9";
+      xmp_["Xmp.video.AspectRatio"] = "16:9";
       break;
     case 10:
-      xmpData_["Xmp.video.AspectRatio"] = "1:1";
+      xmp_["Xmp.video.AspectRatio"] = "1:1";
       break;
     case 16:
-      xmpData_["Xmp.video.AspectRatio"] = "16:10";
+      xmp_["Xmp.video.AspectRatio"] = "16:10";
       break;
     case 22:
-      xmpData_["Xmp.video.AspectRatio"] = "2.21:1";
+      xmp_["Xmp.video.AspectRatio"] = "2.21:1";
       break;
     case 23:
-      xmpData_["Xmp.video.AspectRatio"] = "2.35:1";
+      xmp_["Xmp.video.AspectRatio"] = "2.35:1";
       break;
     case 12:
-      xmpData_["Xmp.video.AspectRatio"] = "5:4";
+      xmp_["Xmp.video.AspectRatio"] = "5:4";
       break;
     default:
-      xmpData_["Xmp.video.AspectRatio"] = aspectRatio;
+      xmp_["Xmp.video.AspectRatio"] = aspectRatio;
       break;
   }
 }  // QuickTimeVideo::aspectRatio
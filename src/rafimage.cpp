@@ -11,6 +11,7 @@
 #include "image.hpp"
 #include "image_int.hpp"
 #include "safe_op.hpp"
+#include "stats_int.hpp"
 #include "tiffimage.hpp"
 
 #include <iostream>
@@ -217,6 +218,7 @@ void RafImage::printStructure(std::ostream& out, PrintStructureOption option, si
 }  // RafImage::printStructure
 
 void RafImage::readMetadata() {
+  EXV_STATS_SCOPE("RafImage::readMetadata");
 #ifdef EXIV2_DEBUG_MESSAGES
   std::cerr << "Reading RAF file " << io_->path() << "\n";
 #endif
@@ -22,15 +22,18 @@
 #include "config.h"
 
 #include "basicio.hpp"
+#include "enforce.hpp"
 #include "error.hpp"
 #include "futils.hpp"
 #include "image_int.hpp"
 #include "riffvideo.hpp"
+#include "stats_int.hpp"
 #include "tags.hpp"
 #include "tags_int.hpp"
 #include "tiffimage_int.hpp"
 #include "types.hpp"
 // + standard includes
+#include <algorithm>
 #include <cmath>
 
 // *****************************************************************************
@@ -421,12 +424,27 @@ constexpr TagDetails nikonAVITags[] = {{0x0003, "Xmp.video.Make"},
 
 enum streamTypeInfo { Audio = 1, MIDI, Text, Video };
 
+/*!
+  @brief Return the FourCC of a RIFF chunk or list as an integer, so that
+      tags can be dispatched with a switch. Letters are converted to upper
+      case, the comparison ignores case like equalsRiffTag().
+ */
+template <typename T>
+constexpr uint32_t riffTag(const T* id) {
+  uint32_t tag = 0;
+  for (size_t i = 0; i < 4; ++i) {
+    const auto c = static_cast<uint8_t>(id[i]);
+    tag = (tag << 8) | (c >= 'a' && c <= 'z' ? c - ('a' - 'A') : c);
+  }
+  return tag;
+}
+
 }  // namespace Exiv2::Internal
 
 namespace Exiv2 {
 using namespace Exiv2::Internal;
 
-RiffVideo::RiffVideo(BasicIo::UniquePtr io) : Image(ImageType::riff, mdNone, std::move(io)) {
+RiffVideo::RiffVideo(BasicIo::UniquePtr io) : Image(ImageType::riff, mdNone, std::move(io)), xmp_(xmpData_) {
 }  // RiffVideo::RiffVideo
 
 std::string RiffVideo::mimeType() const {
@@ -515,6 +533,7 @@ void RiffVideo::writeMetadata() {
 }  // RiffVideo::writeMetadata
 
 void RiffVideo::readMetadata() {
+  EXV_STATS_SCOPE("RiffVideo::readMetadata");
   if (io_->open() != 0)
     throw Error(ErrorCode::kerDataSourceOpenFailed, io_->path(), strError());
 
@@ -527,20 +546,23 @@ void RiffVideo::readMetadata() {
 
   IoCloser closer(*io_);
   clearMetadata();
+  XmpDataFinisher finisher(xmp_);
   continueTraversing_ = true;
+  listEnd_ = false;
+  streamType_ = 0;
 
-  xmpData_["Xmp.video.FileSize"] = io_->size() / 1048576.;
-  xmpData_["Xmp.video.FileName"] = io_->path();
-  xmpData_["Xmp.video.MimeType"] = mimeType();
+  xmp_["Xmp.video.FileSize"] = io_->size() / 1048576.;
+  xmp_["Xmp.video.FileName"] = io_->path();
+  xmp_["Xmp.video.MimeType"] = mimeType();
 
   DataBuf buf(RIFF_TAG_SIZE + 1);
 
   io_->read(buf.data(), RIFF_TAG_SIZE);
-  xmpData_["Xmp.video.Container"] = buf.data();
+  xmp_["Xmp.video.Container"] = buf.data();
 
   io_->read(buf.data(), RIFF_TAG_SIZE);
   io_->read(buf.data(), RIFF_TAG_SIZE);
-  xmpData_["Xmp.video.FileType"] = buf.data();
+  xmp_["Xmp.video.FileType"] = buf.data();
 
   while (continueTraversing_)
     decodeBlock();
@@ -551,74 +573,91 @@ void RiffVideo::decodeBlock() {
   DataBuf buf2(RIFF_TAG_SIZE + 1);
 
   io_->read(buf2.data(), RIFF_TAG_SIZE);
-
-  if (io_->eof() || equalsRiffTag(buf2, "MOVI") || equalsRiffTag(buf2, "DATA")) {
+  io_->read(buf.data(), RIFF_TAG_SIZE);
+  if (io_->eof()) {
     continueTraversing_ = false;
     return;
   }
-  if (equalsRiffTag(buf2, "HDRL") || equalsRiffTag(buf2, "STRL")) {
-    decodeBlock();
-  } else {
-    io_->read(buf.data(), RIFF_TAG_SIZE);
-    size_t size = Exiv2::getULong(buf.data(), littleEndian);
+  size_t size = Exiv2::getULong(buf.data(), littleEndian);
 
-    tagDecoder(buf2, size);
-  }
+  tagDecoder(buf2, size);
 }  // RiffVideo::decodeBlock
 
 void RiffVideo::tagDecoder(Exiv2::DataBuf& buf, size_t size) {
   uint64_t cur_pos = io_->tell();
-  static bool listFlag = false, listEnd = false;
 
-  if (equalsRiffTag(buf, "LIST")) {
-    listFlag = true;
-    listEnd = false;
-
-    while (static_cast<uint64_t>(io_->tell()) < cur_pos + size)
-      decodeBlock();
-
-    listEnd = true;
-    io_->seek(cur_pos + size, BasicIo::beg);
-  } else if (equalsRiffTag(buf, "JUNK") && listEnd) {
-    junkHandler(size);
-  } else if (equalsRiffTag(buf, "AVIH")) {
-    listFlag = false;
-    aviHeaderTagsHandler(size);
-  } else if (equalsRiffTag(buf, "STRH")) {
-    listFlag = false;
-    streamHandler(size);
-  } else if (equalsRiffTag(buf, "STRF") || equalsRiffTag(buf, "FMT ")) {
-    listFlag = false;
-    if (equalsRiffTag(buf, "FMT "))
+  switch (riffTag(buf.c_data())) {
+    case riffTag("LIST"):
+      listHandler(size);
+      break;
+    case riffTag("JUNK"):
+      if (listEnd_)
+        junkHandler(size);
+      else
+        io_->seek(cur_pos + size, BasicIo::beg);
+      break;
+    case riffTag("AVIH"):
+      aviHeaderTagsHandler(size);
+      break;
+    case riffTag("STRH"):
+      streamHandler(size);
+      break;
+    case riffTag("FMT "):
       streamType_ = Audio;
-    streamFormatHandler(size);
-  } else if (equalsRiffTag(buf, "STRN")) {
-    listFlag = false;
-    dateTimeOriginal(size, 1);
-  } else if (equalsRiffTag(buf, "STRD")) {
-    listFlag = false;
-    streamDataTagHandler(size);
-  } else if (equalsRiffTag(buf, "IDIT")) {
-    listFlag = false;
-    dateTimeOriginal(size);
-  } else if (equalsRiffTag(buf, "INFO")) {
-    listFlag = false;
-    infoTagsHandler();
-  } else if (equalsRiffTag(buf, "NCDT")) {
-    listFlag = false;
-    nikonTagsHandler();
-  } else if (equalsRiffTag(buf, "ODML")) {
-    listFlag = false;
-    odmlTagsHandler();
-  } else if (listFlag) {
-    // std::cout<<"|unprocessed|"<<buf.data();
-    skipListData();
-  } else {
-    // std::cout<<"|unprocessed|"<<buf.data();
-    io_->seek(cur_pos + size, BasicIo::beg);
+      streamFormatHandler(size);
+      break;
+    case riffTag("STRF"):
+      streamFormatHandler(size);
+      break;
+    case riffTag("STRN"):
+      dateTimeOriginal(size, 1);
+      break;
+    case riffTag("STRD"):
+      streamDataTagHandler(size);
+      break;
+    case riffTag("IDIT"):
+      dateTimeOriginal(size);
+      break;
+    default:
+      // Media data (data, idx1, RIFF AVIX extensions, ...) is skipped by size, chunks are word aligned
+      io_->seek(cur_pos + size + (size & 1), BasicIo::beg);
+      break;
   }
 }  // RiffVideo::tagDecoder
 
+void RiffVideo::listHandler(size_t size) {
+  const uint64_t cur_pos = io_->tell();
+  DataBuf buf(RIFF_TAG_SIZE + 1);
+  if (size >= RIFF_TAG_SIZE)
+    io_->read(buf.data(), RIFF_TAG_SIZE);
+
+  switch (riffTag(buf.c_data())) {
+    case riffTag("HDRL"):
+    case riffTag("STRL"):
+      listEnd_ = false;
+      while (continueTraversing_ && io_->tell() + 2 * RIFF_TAG_SIZE <= cur_pos + size)
+        decodeBlock();
+      listEnd_ = true;
+      break;
+    case riffTag("INFO"):
+      io_->seek(cur_pos, BasicIo::beg);
+      infoTagsHandler(size);
+      break;
+    case riffTag("NCDT"):
+      io_->seek(cur_pos, BasicIo::beg);
+      nikonTagsHandler(size);
+      break;
+    case riffTag("ODML"):
+      io_->seek(cur_pos, BasicIo::beg);
+      odmlTagsHandler(size);
+      break;
+    default:
+      // movi, rec and unknown lists are skipped without reading their chunks
+      break;
+  }
+  io_->seek(cur_pos + size + (size & 1), BasicIo::beg);
+}  // RiffVideo::listHandler
+
 void RiffVideo::streamDataTagHandler(size_t size) {
   const size_t bufMinSize = 20000;
   DataBuf buf(bufMinSize);
@@ -662,18 +701,15 @@ void RiffVideo::dateTimeOriginal(size_t size, int i) {
   DataBuf buf(bufMinSize);
   io_->read(buf.data(), size);
   if (!i)
-    xmpData_["Xmp.video.DateUTC"] = buf.data();
+    xmp_["Xmp.video.DateUTC"] = buf.data();
   else
-    xmpData_["Xmp.video.StreamName"] = buf.data();
+    xmp_["Xmp.video.StreamName"] = buf.data();
   io_->seek(cur_pos + size, BasicIo::beg);
 }  // RiffVideo::dateTimeOriginal
 
-void RiffVideo::odmlTagsHandler() {
+void RiffVideo::odmlTagsHandler(size_t size) {
   const size_t bufMinSize = 100;
   DataBuf buf(bufMinSize);
-  io_->seek(-12, BasicIo::cur);
-  io_->read(buf.data(), RIFF_TAG_SIZE);
-  size_t size = Exiv2::getULong(buf.data(), littleEndian);
   size_t size2 = size;
 
   uint64_t cur_pos = io_->tell();
@@ -688,22 +724,12 @@ void RiffVideo::odmlTagsHandler() {
       size -= RIFF_TAG_SIZE;
       io_->read(buf.data(), RIFF_TAG_SIZE);
       size -= RIFF_TAG_SIZE;
-      xmpData_["Xmp.video.TotalFrameCount"] = Exiv2::getULong(buf.data(), littleEndian);
+      xmp_["Xmp.video.TotalFrameCount"] = Exiv2::getULong(buf.data(), littleEndian);
     }
   }
   io_->seek(cur_pos + size2, BasicIo::beg);
 }  // RiffVideo::odmlTagsHandler
 
-void RiffVideo::skipListData() {
-  DataBuf buf(RIFF_TAG_SIZE + 1);
-  io_->seek(-12, BasicIo::cur);
-  io_->read(buf.data(), RIFF_TAG_SIZE);
-  size_t size = Exiv2::getULong(buf.data(), littleEndian);
-
-  uint64_t cur_pos = io_->tell();
-  io_->seek(cur_pos + size, BasicIo::beg);
-}  // RiffVideo::skipListData
-
 void RiffVideo::copyTagValue(DataBuf& buf_dest, DataBuf& buf_src, size_t index) {
   buf_dest.data()[0] = buf_src.data()[0 + index];
   buf_dest.data()[1] = buf_src.data()[1 + index];
@@ -711,13 +737,11 @@ void RiffVideo::copyTagValue(DataBuf& buf_dest, DataBuf& buf_src, size_t index)
   buf_dest.data()[3] = buf_src.data()[3 + index];
 }
 
-void RiffVideo::nikonTagsHandler() {
+void RiffVideo::nikonTagsHandler(size_t size) {
   const size_t bufMinSize = 100;
   DataBuf buf(bufMinSize), buf2(RIFF_TAG_SIZE + 1);
-  io_->seek(-12, BasicIo::cur);
-  io_->read(buf.data(), RIFF_TAG_SIZE);
 
-  size_t internal_size = 0, tagID = 0, dataSize = 0, tempSize, size = Exiv2::getULong(buf.data(), littleEndian);
+  size_t internal_size = 0, tagID = 0, dataSize = 0, tempSize;
   tempSize = size;
   char str[9] = " . . . ";
   uint64_t internal_pos, cur_pos;
@@ -752,7 +776,7 @@ void RiffVideo::nikonTagsHandler() {
 #endif
           } else {
             io_->read(buf.data(), dataSize);
-            xmpData_["Xmp.video.MakerNoteType"] = buf.data();
+            xmp_["Xmp.video.MakerNoteType"] = buf.data();
           }
         } else if (tagID == 0x0002) {
           while (dataSize) {
@@ -761,7 +785,7 @@ void RiffVideo::nikonTagsHandler() {
             str[(RIFF_TAG_SIZE - dataSize) * 2] = static_cast<char>(Exiv2::getULong(buf.data(), littleEndian) + 48);
             --dataSize;
           }
-          xmpData_["Xmp.video.MakerNoteVersion"] = str;
+          xmp_["Xmp.video.MakerNoteVersion"] = str;
         }
       }
     } else if (equalsRiffTag(buf, "NCTG")) {
@@ -794,7 +818,7 @@ void RiffVideo::nikonTagsHandler() {
             case 0x001e:
             case 0x001f:
             case 0x0020:
-              xmpData_[exvGettext(td->label_)] = buf.data();
+              xmp_[exvGettext(td->label_)] = buf.data();
               break;
 
             case 0x0007:
@@ -802,7 +826,7 @@ void RiffVideo::nikonTagsHandler() {
             case 0x0011:
             case 0x000c:
             case 0x0012:
-              xmpData_[exvGettext(td->label_)] = Exiv2::getULong(buf.data(), littleEndian);
+              xmp_[exvGettext(td->label_)] = Exiv2::getULong(buf.data(), littleEndian);
               break;
 
             case 0x0008:
@@ -815,9 +839,9 @@ void RiffVideo::nikonTagsHandler() {
               copyTagValue(buf2, buf);
               denominator = static_cast<double>(Exiv2::getLong(buf2.data(), littleEndian));
               if (denominator != 0)
-                xmpData_[exvGettext(td->label_)] = Exiv2::getLong(buf.data(), littleEndian) / denominator;
+                xmp_[exvGettext(td->label_)] = Exiv2::getLong(buf.data(), littleEndian) / denominator;
               else
-                xmpData_[exvGettext(td->label_)] = 0;
+                xmp_[exvGettext(td->label_)] = 0;
               break;
 
             default:
@@ -843,40 +867,32 @@ void RiffVideo::nikonTagsHandler() {
   }
 }  // RiffVideo::nikonTagsHandler
 
-void RiffVideo::infoTagsHandler() {
-  const size_t bufMinSize = 10000;
-  DataBuf buf(bufMinSize);
-  io_->seek(-12, BasicIo::cur);
-  io_->read(buf.data(), RIFF_TAG_SIZE);
-  uint32_t infoSize, size = Exiv2::getULong(buf.data(), littleEndian);
-  uint32_t size_external = size;
-  const TagVocabulary* tv;
-
-  uint64_t cur_pos = io_->tell();
-  io_->read(buf.data(), RIFF_TAG_SIZE);
-  size -= RIFF_TAG_SIZE;
-
-  while (size >= RIFF_TAG_SIZE) {
-    io_->read(buf.data(), RIFF_TAG_SIZE);
-    size -= RIFF_TAG_SIZE;
-    if (!Exiv2::getULong(buf.data(), littleEndian))
+void RiffVideo::infoTagsHandler(size_t size) {
+  // Read the whole list at once and parse its sub-chunks from memory
+  const uint64_t cur_pos = io_->tell();
+  enforce(size <= io_->size() - cur_pos, ErrorCode::kerCorruptedMetadata);
+  DataBuf list(size);
+  io_->readOrThrow(list.data(), size, ErrorCode::kerCorruptedMetadata);
+
+  // Sub-chunks follow the list type
+  size_t pos = RIFF_TAG_SIZE;
+  while (pos + 2 * RIFF_TAG_SIZE <= size) {
+    if (!list.read_uint32(pos, littleEndian))
       break;
-    tv = find(infoTags, Exiv2::toString(buf.data()));
-    io_->read(buf.data(), RIFF_TAG_SIZE);
-    size -= RIFF_TAG_SIZE;
-    infoSize = Exiv2::getULong(buf.data(), littleEndian);
-
-    size -= infoSize;
-    io_->read(buf.data(), infoSize);
-    if (infoSize < RIFF_TAG_SIZE)
-      buf.data()[infoSize] = '\0';
-
-    if (tv)
-      xmpData_[exvGettext(tv->label_)] = buf.data();
-    else
-      continue;
+    const TagVocabulary* tv = find(infoTags, std::string(list.c_str(pos), RIFF_TAG_SIZE));
+    const size_t infoSize = list.read_uint32(pos + RIFF_TAG_SIZE, littleEndian);
+    pos += 2 * RIFF_TAG_SIZE;
+    enforce(infoSize <= size - pos, ErrorCode::kerCorruptedMetadata);
+
+    if (tv) {
+      // Values are zero terminated strings
+      const auto value = list.cbegin() + pos;
+      xmp_[exvGettext(tv->label_)] = std::string(value, std::find(value, value + infoSize, 0));
+    }
+    // Sub-chunks are word aligned
+    pos += infoSize + (infoSize & 1);
   }
-  io_->seek(cur_pos + size_external, BasicIo::beg);
+  io_->seek(cur_pos + size, BasicIo::beg);
 }  // RiffVideo::infoTagsHandler
 
 void RiffVideo::junkHandler(size_t size) {
@@ -888,24 +904,24 @@ void RiffVideo::junkHandler(size_t size) {
   if (equalsRiffTag(buf, "PENT")) {
     io_->seek(cur_pos + 18, BasicIo::beg);
     io_->read(buf.data(), 26);
-    xmpData_["Xmp.video.Make"] = buf.data();
+    xmp_["Xmp.video.Make"] = buf.data();
 
     io_->read(buf.data(), 50);
-    xmpData_["Xmp.video.Model"] = buf.data();
+    xmp_["Xmp.video.Model"] = buf.data();
 
     std::memset(buf.data(), 0x0, buf.size());
     io_->read(buf.data(), 8);
     copyTagValue(buf2, buf);
-    xmpData_["Xmp.video.FNumber"] =
+    xmp_["Xmp.video.FNumber"] =
         static_cast<double>(Exiv2::getLong(buf.data(), littleEndian)) / Exiv2::getLong(buf2.data(), littleEndian);
     ;
 
     io_->seek(cur_pos + 131, BasicIo::beg);
     io_->read(buf.data(), 26);
-    xmpData_["Xmp.video.DateTimeOriginal"] = buf.data();
+    xmp_["Xmp.video.DateTimeOriginal"] = buf.data();
 
     io_->read(buf.data(), 26);
-    xmpData_["Xmp.video.DateTimeDigitized"] = buf.data();
+    xmp_["Xmp.video.DateTimeDigitized"] = buf.data();
 
     io_->seek(cur_pos + 299, BasicIo::beg);
     std::memset(buf.data(), 0x0, buf.size());
@@ -925,7 +941,7 @@ void RiffVideo::junkHandler(size_t size) {
   } else {
     io_->seek(cur_pos, BasicIo::beg);
     io_->read(buf.data(), size);
-    xmpData_["Xmp.video.Junk"] = buf.data();
+    xmp_["Xmp.video.Junk"] = buf.data();
   }
 
   io_->seek(cur_pos + size, BasicIo::beg);
@@ -945,26 +961,26 @@ void RiffVideo::aviHeaderTagsHandler(size_t size) {
 
     switch (tag) {
       case frameRate:
-        xmpData_["Xmp.video.MicroSecPerFrame"] = Exiv2::getULong(buf.data(), littleEndian);
+        xmp_["Xmp.video.MicroSecPerFrame"] = Exiv2::getULong(buf.data(), littleEndian);
         frame_rate = 1000000. / Exiv2::getULong(buf.data(), littleEndian);
         break;
       case (maxDataRate):
-        xmpData_["Xmp.video.MaxDataRate"] = Exiv2::getULong(buf.data(), littleEndian) / 1024.;
+        xmp_["Xmp.video.MaxDataRate"] = Exiv2::getULong(buf.data(), littleEndian) / 1024.;
         break;
       case frameCount:
         frame_count = Exiv2::getULong(buf.data(), littleEndian);
-        xmpData_["Xmp.video.FrameCount"] = frame_count;
+        xmp_["Xmp.video.FrameCount"] = frame_count;
         break;
       case streamCount:
-        xmpData_["Xmp.video.StreamCount"] = Exiv2::getULong(buf.data(), littleEndian);
+        xmp_["Xmp.video.StreamCount"] = Exiv2::getULong(buf.data(), littleEndian);
         break;
       case imageWidth_h:
         width = Exiv2::getULong(buf.data(), littleEndian);
-        xmpData_["Xmp.video.Width"] = width;
+        xmp_["Xmp.video.Width"] = width;
         break;
       case imageHeight_h:
         height = Exiv2::getULong(buf.data(), littleEndian);
-        xmpData_["Xmp.video.Height"] = height;
+        xmp_["Xmp.video.Height"] = height;
         break;
       default:
         break;
@@ -1005,42 +1021,42 @@ void RiffVideo::streamHandler(size_t size) {
     switch (tag) {
       case codec:
         if (streamType_ == Video)
-          xmpData_["Xmp.video.Codec"] = buf.data();
+          xmp_["Xmp.video.Codec"] = buf.data();
         else if (streamType_ == Audio)
-          xmpData_["Xmp.audio.Codec"] = buf.data();
+          xmp_["Xmp.audio.Codec"] = buf.data();
         else
-          xmpData_["Xmp.video.Codec"] = buf.data();
+          xmp_["Xmp.video.Codec"] = buf.data();
         break;
       case sampleRateDivisor:
         divisor = Exiv2::getULong(buf.data(), littleEndian);
         break;
       case sampleRate:
         if (streamType_ == Video)
-          xmpData_["Xmp.video.FrameRate"] = returnSampleRate(buf, divisor);
+          xmp_["Xmp.video.FrameRate"] = returnSampleRate(buf, divisor);
         else if (streamType_ == Audio)
-          xmpData_["Xmp.audio.SampleRate"] = returnSampleRate(buf, divisor);
+          xmp_["Xmp.audio.SampleRate"] = returnSampleRate(buf, divisor);
         else
-          xmpData_["Xmp.video.StreamSampleRate"] = returnSampleRate(buf, divisor);
+          xmp_["Xmp.video.StreamSampleRate"] = returnSampleRate(buf, divisor);
         break;
       case sampleCount:
         if (streamType_ == Video)
-          xmpData_["Xmp.video.FrameCount"] = Exiv2::getULong(buf.data(), littleEndian);
+          xmp_["Xmp.video.FrameCount"] = Exiv2::getULong(buf.data(), littleEndian);
         else if (streamType_ == Audio)
-          xmpData_["Xmp.audio.SampleCount"] = Exiv2::getULong(buf.data(), littleEndian);
+          xmp_["Xmp.audio.SampleCount"] = Exiv2::getULong(buf.data(), littleEndian);
         else
-          xmpData_["Xmp.video.StreamSampleCount"] = Exiv2::getULong(buf.data(), littleEndian);
+          xmp_["Xmp.video.StreamSampleCount"] = Exiv2::getULong(buf.data(), littleEndian);
         break;
       case quality:
         if (streamType_ == Video)
-          xmpData_["Xmp.video.VideoQuality"] = Exiv2::getULong(buf.data(), littleEndian);
+          xmp_["Xmp.video.VideoQuality"] = Exiv2::getULong(buf.data(), littleEndian);
         else if (streamType_ != Audio)
-          xmpData_["Xmp.video.StreamQuality"] = Exiv2::getULong(buf.data(), littleEndian);
+          xmp_["Xmp.video.StreamQuality"] = Exiv2::getULong(buf.data(), littleEndian);
         break;
       case sampleSize:
         if (streamType_ == Video)
-          xmpData_["Xmp.video.VideoSampleSize"] = Exiv2::getULong(buf.data(), littleEndian);
+          xmp_["Xmp.video.VideoSampleSize"] = Exiv2::getULong(buf.data(), littleEndian);
         else if (streamType_ != Audio)
-          xmpData_["Xmp.video.StreamSampleSize"] = Exiv2::getULong(buf.data(), littleEndian);
+          xmp_["Xmp.video.StreamSampleSize"] = Exiv2::getULong(buf.data(), littleEndian);
         break;
       default:
         break;
@@ -1081,42 +1097,42 @@ void RiffVideo::streamFormatHandler(size_t size) {
           break;
         case planes:
           io_->read(buf.data(), 2);
-          xmpData_["Xmp.video.Planes"] = Exiv2::getUShort(buf.data(), littleEndian);
+          xmp_["Xmp.video.Planes"] = Exiv2::getUShort(buf.data(), littleEndian);
           break;
         case bitDepth:
           io_->read(buf.data(), 2);
-          xmpData_["Xmp.video.PixelDepth"] = Exiv2::getUShort(buf.data(), littleEndian);
+          xmp_["Xmp.video.PixelDepth"] = Exiv2::getUShort(buf.data(), littleEndian);
           break;
         case compression:
           io_->read(buf.data(), RIFF_TAG_SIZE);
-          xmpData_["Xmp.video.Compressor"] = buf.data();
+          xmp_["Xmp.video.Compressor"] = buf.data();
           break;
         case imageLength:
           io_->read(buf.data(), RIFF_TAG_SIZE);
-          xmpData_["Xmp.video.ImageLength"] = Exiv2::getULong(buf.data(), littleEndian);
+          xmp_["Xmp.video.ImageLength"] = Exiv2::getULong(buf.data(), littleEndian);
           break;
         case pixelsPerMeterX:
           io_->read(buf.data(), RIFF_TAG_SIZE);
-          xmpData_["Xmp.video.PixelPerMeterX"] = Exiv2::getULong(buf.data(), littleEndian);
+          xmp_["Xmp.video.PixelPerMeterX"] = Exiv2::getULong(buf.data(), littleEndian);
           break;
         case pixelsPerMeterY:
           io_->read(buf.data(), RIFF_TAG_SIZE);
-          xmpData_["Xmp.video.PixelPerMeterY"] = Exiv2::getULong(buf.data(), littleEndian);
+          xmp_["Xmp.video.PixelPerMeterY"] = Exiv2::getULong(buf.data(), littleEndian);
           break;
         case numColors:
           io_->read(buf.data(), RIFF_TAG_SIZE);
           if (Exiv2::getULong(buf.data(), littleEndian) == 0) {
-            xmpData_["Xmp.video.NumOfColours"] = "Unspecified";
+            xmp_["Xmp.video.NumOfColours"] = "Unspecified";
           } else {
-            xmpData_["Xmp.video.NumOfColours"] = Exiv2::getULong(buf.data(), littleEndian);
+            xmp_["Xmp.video.NumOfColours"] = Exiv2::getULong(buf.data(), littleEndian);
           }
           break;
         case numImportantColors:
           io_->read(buf.data(), RIFF_TAG_SIZE);
           if (Exiv2::getULong(buf.data(), littleEndian)) {
-            xmpData_["Xmp.video.NumIfImpColours"] = Exiv2::getULong(buf.data(), littleEndian);
+            xmp_["Xmp.video.NumIfImpColours"] = Exiv2::getULong(buf.data(), littleEndian);
           } else {
-            xmpData_["Xmp.video.NumOfImpColours"] = "All";
+            xmp_["Xmp.video.NumOfImpColours"] = "All";
           }
           break;
         default:
@@ -1134,32 +1150,32 @@ void RiffVideo::streamFormatHandler(size_t size) {
         case encoding:
           td = find(audioEncodingValues, Exiv2::getUShort(buf.data(), littleEndian));
           if (td) {
-            xmpData_["Xmp.audio.Compressor"] = exvGettext(td->label_);
+            xmp_["Xmp.audio.Compressor"] = exvGettext(td->label_);
           } else {
-            xmpData_["Xmp.audio.Compressor"] = Exiv2::getUShort(buf.data(), littleEndian);
+            xmp_["Xmp.audio.Compressor"] = Exiv2::getUShort(buf.data(), littleEndian);
           }
           break;
         case numberOfChannels:
           c = Exiv2::getUShort(buf.data(), littleEndian);
           if (c == 1)
-            xmpData_["Xmp.audio.ChannelType"] = "Mono";
+            xmp_["Xmp.audio.ChannelType"] = "Mono";
           else if (c == 2)
-            xmpData_["Xmp.audio.ChannelType"] = "Stereo";
+            xmp_["Xmp.audio.ChannelType"] = "Stereo";
           else if (c == 5)
-            xmpData_["Xmp.audio.ChannelType"] = "5.1 Surround Sound";
+            xmp_["Xmp.audio.ChannelType"] = "5.1 Surround Sound";
           else if (c == 7)
-            xmpData_["Xmp.audio.ChannelType"] = "7.1 Surround Sound";
+            xmp_["Xmp.audio.ChannelType"] = "7.1 Surround Sound";
           else
-            xmpData_["Xmp.audio.ChannelType"] = "Mono";
+            xmp_["Xmp.audio.ChannelType"] = "Mono";
           break;
         case audioSampleRate:
-          xmpData_["Xmp.audio.SampleRate"] = Exiv2::getUShort(buf.data(), littleEndian);
+          xmp_["Xmp.audio.SampleRate"] = Exiv2::getUShort(buf.data(), littleEndian);
           break;
         case avgBytesPerSec:
-          xmpData_["Xmp.audio.SampleType"] = Exiv2::getUShort(buf.data(), littleEndian);
+          xmp_["Xmp.audio.SampleType"] = Exiv2::getUShort(buf.data(), littleEndian);
           break;
         case bitsPerSample:
-          xmpData_["Xmp.audio.BitsPerSample"] = Exiv2::getUShort(buf.data(), littleEndian);
+          xmp_["Xmp.audio.BitsPerSample"] = Exiv2::getUShort(buf.data(), littleEndian);
           io_->read(buf.data(), 2);
           break;
         default:
@@ -1188,34 +1204,34 @@ void RiffVideo::fillAspectRatio(size_t width, size_t height) {
     return;
   double aspectRatio = static_cast<double>(width) / height;
   aspectRatio = floor(aspectRatio * 10) / 10;
-  xmpData_["Xmp.video.AspectRatio"] = aspectRatio;
+  xmp_["Xmp.video.AspectRatio"] = aspectRatio;
 
   auto aR = static_cast<int>((aspectRatio * 10.0) + 0.1);
 
   switch (aR) {
     case 13:
-      xmpData_["Xmp.video.AspectRatio"] = "4:3";
+      xmp_["Xmp.video.AspectRatio"] = "4:3";
       break;
     case 17:
-      xmpData_["Xmp.video.AspectRatio"] = "16:9";
+      xmp_["Xmp.video.AspectRatio"] = "16:9";
       break;
     case 10:
-      xmpData_["Xmp.video.AspectRatio"] = "1:1";
+      xmp_["Xmp.video.AspectRatio"] = "1:1";
       break;
     case 16:
-      xmpData_["Xmp.video.AspectRatio"] = "16:10";
+      xmp_["Xmp.video.AspectRatio"] = "16:10";
       break;
     case 22:
-      xmpData_["Xmp.video.AspectRatio"] = "2.21:1";
+      xmp_["Xmp.video.AspectRatio"] = "2.21:1";
       break;
     case 23:
-      xmpData_["Xmp.video.AspectRatio"] = "2.35:1";
+      xmp_["Xmp.video.AspectRatio"] = "2.35:1";
       break;
     case 12:
-      xmpData_["Xmp.video.AspectRatio"] = "5:4";
+      xmp_["Xmp.video.AspectRatio"] = "5:4";
       break;
     default:
-      xmpData_["Xmp.video.AspectRatio"] = aspectRatio;
+      xmp_["Xmp.video.AspectRatio"] = aspectRatio;
       break;
   }
 }  // RiffVideo::fillAspectRatio
@@ -1225,8 +1241,8 @@ void RiffVideo::fillDuration(double frame_rate, size_t frame_count) {
     return;
 
   auto duration = static_cast<uint64_t>(frame_count * 1000. / frame_rate);
-  xmpData_["Xmp.video.FileDataRate"] = io_->size() / (1048576. * duration);
-  xmpData_["Xmp.video.Duration"] = duration;  // Duration in number of seconds
+  xmp_["Xmp.video.FileDataRate"] = io_->size() / (1048576. * duration);
+  xmp_["Xmp.video.Duration"] = duration;  // Duration in number of seconds
 }  // RiffVideo::fillDuration
 
 Image::UniquePtr newRiffInstance(BasicIo::UniquePtr io, bool /*create*/) {
@@ -9,6 +9,7 @@
 #include "image.hpp"
 #include "preview.hpp"
 #include "rw2image_int.hpp"
+#include "stats_int.hpp"
 #include "tiffcomposite_int.hpp"
 #include "tiffimage_int.hpp"
 
@@ -78,6 +79,7 @@ void Rw2Image::printStructure(std::ostream& out, PrintStructureOption option, si
 }  // Rw2Image::printStructure
 
 void Rw2Image::readMetadata() {
+  EXV_STATS_SCOPE("Rw2Image::readMetadata");
 #ifdef EXIV2_DEBUG_MESSAGES
   std::cerr << "Reading RW2 file " << io_->path() << "\n";
 #endif
@@ -0,0 +1,64 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// included header files
+#include "stats.hpp"
+#include "image_int.hpp"
+#include "stats_int.hpp"
+
+// *****************************************************************************
+// class member definitions
+namespace Exiv2 {
+#ifdef EXV_ENABLE_STATS
+bool Stats::enabled() {
+  return true;
+}
+
+void Stats::reset() {
+  Internal::resetStats();
+}
+
+std::vector<Stats::Phase> Stats::phases() {
+  return Internal::statsPhases();
+}
+
+Stats::Counters Stats::counters() {
+  return Internal::statsCounters();
+}
+#else
+bool Stats::enabled() {
+  return false;
+}
+
+void Stats::reset() {
+}
+
+std::vector<Stats::Phase> Stats::phases() {
+  return {};
+}
+
+Stats::Counters Stats::counters() {
+  return {};
+}
+#endif  // EXV_ENABLE_STATS
+
+void Stats::print(std::ostream& os) {
+  os << Internal::stringFormat("%-48s %8s %12s\n", "phase", "calls", "time (ms)");
+  for (const auto& phase : phases()) {
+    const auto slash = phase.name_.rfind('/');
+    const auto label = Internal::indent(phase.depth_) + phase.name_.substr(slash == std::string::npos ? 0 : slash + 1);
+    os << Internal::stringFormat("%-48s %8llu %12.3f\n", label.c_str(), static_cast<unsigned long long>(phase.calls_),
+                                 std::chrono::duration<double, std::milli>(phase.time_).count());
+  }
+
+  const auto c = counters();
+  os << Internal::stringFormat("%-48s %8llu %12llu\n", "reads / bytes", static_cast<unsigned long long>(c.reads_),
+                               static_cast<unsigned long long>(c.bytesRead_))
+     << Internal::stringFormat("%-48s %8llu\n", "seeks", static_cast<unsigned long long>(c.seeks_))
+     << Internal::stringFormat("%-48s %8llu %12llu\n", "writes / bytes", static_cast<unsigned long long>(c.writes_),
+                               static_cast<unsigned long long>(c.bytesWritten_))
+     << Internal::stringFormat("%-48s %8llu %12llu\n", "allocations / bytes",
+                               static_cast<unsigned long long>(c.allocations_),
+                               static_cast<unsigned long long>(c.bytesAllocated_));
+}
+
+}  // namespace Exiv2
@@ -0,0 +1,86 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// included header files
+#include "stats_int.hpp"
+
+#include <cstring>
+
+// *****************************************************************************
+// class member definitions
+#ifdef EXV_ENABLE_STATS
+namespace Exiv2::Internal {
+namespace {
+//! A phase with the information needed to find it again
+struct PhaseEntry {
+  Stats::Phase phase_;  //!< Public part of the phase
+  size_t parent_;       //!< Index of the enclosing phase, or npos
+  const char* label_;   //!< Name of the phase within its parent
+};
+
+//! Statistics of one thread
+struct ThreadStats {
+  static constexpr size_t npos = static_cast<size_t>(-1);
+
+  std::vector<PhaseEntry> phases_;  //!< Phases in the order they were first entered
+  std::vector<size_t> running_;     //!< Indices of the phases currently running
+  Stats::Counters counters_;        //!< I/O and allocation counters
+
+  //! Return the index of the phase \em label below the running phase, adding it if needed
+  size_t enter(const char* label) {
+    const size_t parent = running_.empty() ? npos : running_.back();
+    size_t index = 0;
+    while (index < phases_.size() &&
+           (phases_[index].parent_ != parent || std::strcmp(phases_[index].label_, label) != 0))
+      ++index;
+    if (index == phases_.size()) {
+      std::string name = parent == npos ? label : phases_[parent].phase_.name_ + "/" + label;
+      phases_.push_back({{std::move(name), running_.size(), 0, std::chrono::nanoseconds(0)}, parent, label});
+    }
+    running_.push_back(index);
+    return index;
+  }
+};
+
+ThreadStats& threadStats() {
+  thread_local ThreadStats stats;
+  return stats;
+}
+}  // namespace
+
+ScopedTimer::ScopedTimer(const char* name) :
+    phase_(threadStats().enter(name)), start_(std::chrono::steady_clock::now()) {
+}
+
+ScopedTimer::~ScopedTimer() {
+  auto& stats = threadStats();
+  auto& phase = stats.phases_[phase_].phase_;
+  phase.calls_++;
+  phase.time_ += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_);
+  stats.running_.pop_back();
+}
+
+Stats::Counters& statsCounters() {
+  return threadStats().counters_;
+}
+
+std::vector<Stats::Phase> statsPhases() {
+  std::vector<Stats::Phase> result;
+  for (const auto& entry : threadStats().phases_)
+    result.push_back(entry.phase_);
+  return result;
+}
+
+void resetStats() {
+  auto& stats = threadStats();
+  // phases which are still running keep their entries, their times are discarded
+  for (auto& entry : stats.phases_) {
+    entry.phase_.calls_ = 0;
+    entry.phase_.time_ = std::chrono::nanoseconds(0);
+  }
+  if (stats.running_.empty())
+    stats.phases_.clear();
+  stats.counters_ = {};
+}
+
+}  // namespace Exiv2::Internal
+#endif  // EXV_ENABLE_STATS
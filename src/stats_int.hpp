@@ -0,0 +1,59 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef STATS_INT_HPP_
+#define STATS_INT_HPP_
+
+// *****************************************************************************
+// included header files
+#include "config.h"
+#include "stats.hpp"
+
+#include <chrono>
+#include <cstddef>  // for size_t
+#include <vector>
+
+// *****************************************************************************
+// namespace extensions
+namespace Exiv2::Internal {
+// *****************************************************************************
+// class definitions
+
+#ifdef EXV_ENABLE_STATS
+/*!
+  @brief Time the enclosing scope as a phase of Stats. Phases entered while
+         another one is running are recorded as its children.
+ */
+class ScopedTimer {
+ public:
+  //! Enter the phase \em name, which must be a string literal
+  explicit ScopedTimer(const char* name);
+  //! Leave the phase and add the elapsed time to it
+  ~ScopedTimer();
+
+  ScopedTimer(const ScopedTimer&) = delete;
+  ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+ private:
+  size_t phase_;                                 //!< Index of the phase
+  std::chrono::steady_clock::time_point start_;  //!< Time the phase was entered
+};
+
+//! Return the counters of the calling thread
+Stats::Counters& statsCounters();
+//! Return the phases of the calling thread, in the order they were first entered
+std::vector<Stats::Phase> statsPhases();
+//! Clear the statistics of the calling thread
+void resetStats();
+
+//! Time the enclosing scope as the phase \em name
+#define EXV_STATS_SCOPE(name) const Exiv2::Internal::ScopedTimer exvStatsTimer(name)
+//! Add \em n to the counter \em counter of the calling thread
+#define EXV_STATS_COUNT(counter, n) (Exiv2::Internal::statsCounters().counter += (n))
+#else
+#define EXV_STATS_SCOPE(name) static_cast<void>(0)
+#define EXV_STATS_COUNT(counter, n) static_cast<void>(0)
+#endif  // EXV_ENABLE_STATS
+
+}  // namespace Exiv2::Internal
+
+#endif  // #ifndef STATS_INT_HPP_
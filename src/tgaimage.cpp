@@ -8,6 +8,7 @@
 #include "error.hpp"
 #include "futils.hpp"
 #include "image.hpp"
+#include "stats_int.hpp"
 
 #include <iostream>
 
@@ -37,6 +38,7 @@ void TgaImage::setComment(const std::string&) {
 }
 
 void TgaImage::readMetadata() {
+  EXV_STATS_SCOPE("TgaImage::readMetadata");
 #ifdef EXIV2_DEBUG_MESSAGES
   std::cerr << "Exiv2::TgaImage::readMetadata: Reading TARGA file " << io_->path() << "\n";
 #endif
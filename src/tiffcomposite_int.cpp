@@ -7,6 +7,7 @@
 #include "makernote_int.hpp"
 #include "safe_op.hpp"
 #include "sonymn_int.hpp"
+#include "stats_int.hpp"
 #include "tiffcomposite_int.hpp"
 #include "tiffimage_int.hpp"
 #include "tiffvisitor_int.hpp"
@@ -25,8 +26,10 @@ size_t fillGap(Exiv2::Internal::IoWrapper& ioWrapper, size_t curr, size_t tobe);
 // class member definitions
 namespace Exiv2::Internal {
 bool TiffMappingInfo::operator==(const TiffMappingInfo::Key& key) const {
-  return (0 == strcmp("*", make_) || startsWith(key.m_, make_)) &&
-         (Tag::all == extendedTag_ || key.e_ == extendedTag_) && key.g_ == group_;
+  // Check the cheap integer fields first, the make is only compared for
+  // entries which match the tag and group
+  return key.g_ == group_ && (Tag::all == extendedTag_ || key.e_ == extendedTag_) &&
+         (0 == strcmp("*", make_) || startsWith(key.m_, make_));
 }
 
 IoWrapper::IoWrapper(BasicIo& io, const byte* pHeader, size_t size, OffsetWriter* pow) :
@@ -697,6 +700,7 @@ void TiffSubIfd::doAccept(TiffVisitor& visitor) {
 }  // TiffSubIfd::doAccept
 
 void TiffMnEntry::doAccept(TiffVisitor& visitor) {
+  EXV_STATS_SCOPE("TiffMnEntry::accept");
   visitor.visitMnEntry(this);
   if (mn_)
     mn_->accept(visitor);
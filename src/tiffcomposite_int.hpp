@@ -8,6 +8,7 @@
 #include "tifffwd_int.hpp"
 
 #include <memory>
+#include <string_view>
 
 // *****************************************************************************
 // namespace extensions
@@ -367,11 +368,11 @@ struct TiffMappingInfo {
 //! Search key for TIFF mapping structures.
 struct TiffMappingInfo::Key {
   //! Constructor
-  Key(std::string m, uint32_t e, IfdId g) : m_(std::move(m)), e_(e), g_(g) {
+  Key(std::string_view m, uint32_t e, IfdId g) : m_(m), e_(e), g_(g) {
   }
-  std::string m_;  //!< Camera make
-  uint32_t e_;     //!< Extended tag
-  IfdId g_;        //!< %Group
+  std::string_view m_;  //!< Camera make
+  uint32_t e_;          //!< Extended tag
+  IfdId g_;             //!< %Group
 };
 
 /*!
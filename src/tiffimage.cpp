@@ -8,6 +8,7 @@
 #include "error.hpp"
 #include "futils.hpp"
 #include "image.hpp"
+#include "stats_int.hpp"
 #include "tiffcomposite_int.hpp"
 #include "tiffimage_int.hpp"
 #include "types.hpp"
@@ -65,6 +66,13 @@ std::string TiffImage::mimeType() const {
   return mimeType_;
 }
 
+void TiffImage::doReopen() {
+  primaryGroup_.clear();
+  mimeType_.clear();
+  pixelWidthPrimary_ = 0;
+  pixelHeightPrimary_ = 0;
+}
+
 std::string TiffImage::primaryGroup() const {
   if (!primaryGroup_.empty())
     return primaryGroup_;
@@ -123,6 +131,7 @@ void TiffImage::setComment(const std::string&) {
 }
 
 void TiffImage::readMetadata() {
+  EXV_STATS_SCOPE("TiffImage::readMetadata");
 #ifdef EXIV2_DEBUG_MESSAGES
   std::cerr << "Reading TIFF file " << io_->path() << "\n";
 #endif
@@ -156,6 +165,7 @@ void TiffImage::readMetadata() {
 }
 
 void TiffImage::writeMetadata() {
+  EXV_STATS_SCOPE("TiffImage::writeMetadata");
 #ifdef EXIV2_DEBUG_MESSAGES
   std::cerr << "Writing TIFF file " << io_->path() << "\n";
 #endif
@@ -212,19 +222,8 @@ ByteOrder TiffParser::decode(ExifData& exifData, IptcData& iptcData, XmpData& xm
 
 WriteMethod TiffParser::encode(BasicIo& io, const byte* pData, size_t size, ByteOrder byteOrder,
                                const ExifData& exifData, const IptcData& iptcData, const XmpData& xmpData) {
-  // Copy to be able to modify the Exif data
-  ExifData ed = exifData;
-
-  // Delete IFDs which do not occur in TIFF images
-  static constexpr auto filteredIfds = std::array{
-      IfdId::panaRawId,
-  };
-  for (auto filteredIfd : filteredIfds) {
-#ifdef EXIV2_DEBUG_MESSAGES
-    std::cerr << "Warning: Exif IFD " << filteredIfd << " not encoded\n";
-#endif
-    ed.erase(std::remove_if(ed.begin(), ed.end(), FindExifdatum(filteredIfd)), ed.end());
-  }
+  ExifData filtered;
+  const ExifData& ed = filterTiffExifData(exifData, filtered);
 
   TiffHeader header(byteOrder);
   return TiffParserWorker::encode(io, pData, size, ed, iptcData, xmpData, Tag::root, TiffMapping::findEncoder, &header,
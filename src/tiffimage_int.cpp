@@ -5,9 +5,11 @@
 #include "i18n.h"  // NLS support.
 #include "makernote_int.hpp"
 #include "sonymn_int.hpp"
+#include "stats_int.hpp"
 #include "tags_int.hpp"
 #include "tiffvisitor_int.hpp"
 
+#include <algorithm>
 #include <array>
 #include <iostream>
 
@@ -2023,6 +2025,7 @@ void TiffCreator::getPath(TiffPath& tiffPath, uint32_t extendedTag, IfdId group,
 
 ByteOrder TiffParserWorker::decode(ExifData& exifData, IptcData& iptcData, XmpData& xmpData, const byte* pData,
                                    size_t size, uint32_t root, FindDecoderFct findDecoderFct, TiffHeaderBase* pHeader) {
+  EXV_STATS_SCOPE("TiffParserWorker::decode");
   // Create standard TIFF header if necessary
   std::unique_ptr<TiffHeaderBase> ph;
   if (!pHeader) {
@@ -2043,6 +2046,7 @@ WriteMethod TiffParserWorker::encode(BasicIo& io, const byte* pData, size_t size
                                      const IptcData& iptcData, const XmpData& xmpData, uint32_t root,
                                      FindEncoderFct findEncoderFct, TiffHeaderBase* pHeader,
                                      OffsetWriter* pOffsetWriter) {
+  EXV_STATS_SCOPE("TiffParserWorker::encode");
   /*
      1) parse the binary image, if one is provided, and
      2) attempt updating the parsed tree in-place ("non-intrusive writing")
@@ -2093,6 +2097,28 @@ WriteMethod TiffParserWorker::encode(BasicIo& io, const byte* pData, size_t size
   return writeMethod;
 }  // TiffParserWorker::encode
 
+const ExifData& filterTiffExifData(const ExifData& exifData, ExifData& filtered) {
+  // IFDs which do not occur in TIFF images
+  static constexpr auto filteredIfds = std::array{
+      IfdId::panaRawId,
+  };
+  const ExifData* pExifData = &exifData;
+  for (auto filteredIfd : filteredIfds) {
+    if (std::none_of(pExifData->begin(), pExifData->end(), FindExifdatum(filteredIfd)))
+      continue;
+#ifdef EXIV2_DEBUG_MESSAGES
+    std::cerr << "Warning: Exif IFD " << filteredIfd << " not encoded\n";
+#endif
+    // Copy to be able to modify the Exif data
+    if (pExifData != &filtered) {
+      filtered = exifData;
+      pExifData = &filtered;
+    }
+    filtered.erase(std::remove_if(filtered.begin(), filtered.end(), FindExifdatum(filteredIfd)), filtered.end());
+  }
+  return *pExifData;
+}
+
 TiffComponent::UniquePtr TiffParserWorker::parse(const byte* pData, size_t size, uint32_t root,
                                                  TiffHeaderBase* pHeader) {
   if (!pData || size == 0)
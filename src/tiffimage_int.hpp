@@ -364,6 +364,20 @@ class FindExifdatum {
 
 };  // class FindExifdatum
 
+/*!
+  @brief Return the Exif data to encode into a TIFF-based image, without
+         the entries of IFDs which do not occur in TIFF images.
+
+  The metadata is only copied to \em filtered if there is something to
+  remove, otherwise a reference to \em exifData is returned. This avoids
+  copying every Exifdatum on each write of a TIFF-based image.
+
+  @param exifData Exif metadata to encode.
+  @param filtered Storage for the filtered copy, if one is needed.
+  @return Reference to either \em exifData or \em filtered.
+ */
+const ExifData& filterTiffExifData(const ExifData& exifData, ExifData& filtered);
+
 }  // namespace Exiv2::Internal
 
 #endif  // #ifndef TIFFIMAGE_INT_HPP_
@@ -7,6 +7,7 @@
 #include "futils.hpp"
 #include "i18n.h"  // for _exvGettext
 #include "safe_op.hpp"
+#include "stats_int.hpp"
 
 // + standard includes
 #include <array>
@@ -91,13 +92,19 @@ size_t TypeInfo::typeSize(TypeId typeId) {
 }
 
 DataBuf::DataBuf(size_t size) : pData_(size) {
+  EXV_STATS_COUNT(allocations_, 1);
+  EXV_STATS_COUNT(bytesAllocated_, size);
 }
 
 DataBuf::DataBuf(const byte* pData, size_t size) : pData_(size) {
+  EXV_STATS_COUNT(allocations_, 1);
+  EXV_STATS_COUNT(bytesAllocated_, size);
   std::copy_n(pData, size, pData_.begin());
 }
 
 void DataBuf::alloc(size_t size) {
+  EXV_STATS_COUNT(allocations_, 1);
+  EXV_STATS_COUNT(bytesAllocated_, size);
   pData_.resize(size);
 }
 
@@ -639,9 +646,8 @@ Rational floatToRationalCast(float f) {
 #ifdef EXV_ENABLE_NLS
 // Declaration is in i18n.h
 const char* _exvGettext(const char* str) {
-  static bool exvGettextInitialized = false;
-
-  if (!exvGettextInitialized) {
+  // bind the text domain once, the initialization of a local static is thread-safe
+  [[maybe_unused]] static const bool exvGettextInitialized = [] {
     // bindtextdomain(EXV_PACKAGE_NAME, EXV_LOCALEDIR);
     const std::string localeDir =
         EXV_LOCALEDIR[0] == '/' ? EXV_LOCALEDIR : (Exiv2::getProcessPath() + EXV_SEPARATOR_STR + EXV_LOCALEDIR);
@@ -649,8 +655,8 @@ const char* _exvGettext(const char* str) {
 #ifdef EXV_HAVE_BIND_TEXTDOMAIN_CODESET
     bind_textdomain_codeset(EXV_PACKAGE_NAME, "UTF-8");
 #endif
-    exvGettextInitialized = true;
-  }
+    return true;
+  }();
 
   return dgettext(EXV_PACKAGE_NAME, str);
 }
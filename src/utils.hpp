@@ -1,13 +1,35 @@
 #ifndef EXIV2_UTILS_HPP
 #define EXIV2_UTILS_HPP
 
+#include <array>
+#include <cstdint>
 #include <string>
 #include <string_view>
 
 namespace Exiv2::Internal {
 
+//! Marks characters which are not hex digits in @ref hexDigitValues
+inline constexpr uint8_t notAHexDigit = 0xff;
+
+/// @brief Value of each hex digit ('0'-'9', 'a'-'f' and 'A'-'F'), @ref notAHexDigit for all other characters
+inline constexpr auto hexDigitValues = [] {
+  std::array<uint8_t, 256> values{};
+  for (auto& v : values)
+    v = notAHexDigit;
+  for (uint8_t i = 0; i < 10; ++i)
+    values['0' + i] = i;
+  for (uint8_t i = 0; i < 6; ++i) {
+    values['a' + i] = static_cast<uint8_t>(10 + i);
+    values['A' + i] = static_cast<uint8_t>(10 + i);
+  }
+  return values;
+}();
+
+//! Lowercase hex digits, indexed by their value
+inline constexpr std::string_view hexDigits = "0123456789abcdef";
+
 constexpr bool startsWith(std::string_view s, std::string_view start) {
-  return s.find(start) == 0;
+  return s.size() >= start.size() && s.substr(0, start.size()) == start;
 }
 
 /// @brief Returns the uppercase version of \b str
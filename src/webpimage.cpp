@@ -15,11 +15,28 @@
 #include "futils.hpp"
 #include "image_int.hpp"
 #include "safe_op.hpp"
+#include "stats_int.hpp"
 #include "types.hpp"
 
+#include <algorithm>
 #include <iostream>
+#include <vector>
 
 namespace {
+//! Number of leading payload bytes that hold the canvas size of VP8X, VP8, VP8L and ANMF chunks
+constexpr uint32_t canvasHeaderSize = 12;
+
+//! Copy size bytes from the current position of src to dst, using buf as bounce buffer
+void copyBytes(Exiv2::BasicIo& src, Exiv2::BasicIo& dst, size_t size, Exiv2::DataBuf& buf) {
+  while (size > 0) {
+    const size_t n = std::min(size, buf.size());
+    src.readOrThrow(buf.data(), n, Exiv2::ErrorCode::kerCorruptedMetadata);
+    if (dst.write(buf.c_data(), n) != n)
+      throw Exiv2::Error(Exiv2::ErrorCode::kerImageWriteFailed);
+    size -= n;
+  }
+}
+
 [[maybe_unused]] std::string binaryToHex(const uint8_t* data, size_t size) {
   std::stringstream hexOutput;
 
@@ -91,6 +108,7 @@ void WebPImage::setComment(const std::string&) {
 /* =========================================== */
 
 void WebPImage::writeMetadata() {
+  EXV_STATS_SCOPE("WebPImage::writeMetadata");
   if (io_->open() != 0) {
     throw Error(ErrorCode::kerDataSourceOpenFailed, io_->path(), strError());
   }
@@ -150,22 +168,36 @@ void WebPImage::doWriteMetadata(BasicIo& outIo) {
   has_xmp = !xmpPacket_.empty();
   std::string xmp(xmpPacket_);
 
+  //! Position of a chunk in the source file, recorded on the first pass
+  struct Chunk {
+    byte id[WEBP_TAG_SIZE];
+    size_t offset;  //!< Offset of the payload
+    uint32_t size;  //!< Size of the payload, without the pad byte
+  };
+  std::vector<Chunk> chunks;
+
   /* Verify for a VP8X Chunk First before writing in
    case we have any exif or xmp data, also check
-   for any chunks with alpha frame/layer set */
+   for any chunks with alpha frame/layer set.
+   Only the leading bytes of each payload are read;
+   image data is copied once, on the second pass. */
+  DataBuf payloadHead(canvasHeaderSize);
   while (!io_->eof() && io_->tell() < filesize) {
     io_->readOrThrow(chunkId.data(), WEBP_TAG_SIZE, Exiv2::ErrorCode::kerCorruptedMetadata);
     io_->readOrThrow(size_buff, WEBP_TAG_SIZE, Exiv2::ErrorCode::kerCorruptedMetadata);
     const uint32_t size_u32 = Exiv2::getULong(size_buff, littleEndian);
 
-    DataBuf payload(size_u32);
-    if (!payload.empty()) {
-      io_->readOrThrow(payload.data(), payload.size(), Exiv2::ErrorCode::kerCorruptedMetadata);
-      if (payload.size() % 2) {
-        byte c = 0;
-        io_->readOrThrow(&c, 1, Exiv2::ErrorCode::kerCorruptedMetadata);
-      }
-    }
+    const size_t offset = io_->tell();
+    enforce(size_u32 + static_cast<size_t>(size_u32 % 2) <= io_->size() - offset,
+            Exiv2::ErrorCode::kerCorruptedMetadata);
+    auto& chunk = chunks.emplace_back();
+    std::copy_n(chunkId.c_data(), WEBP_TAG_SIZE, chunk.id);
+    chunk.offset = offset;
+    chunk.size = size_u32;
+
+    const size_t headerSize = std::min(size_u32, canvasHeaderSize);
+    io_->readOrThrow(payloadHead.data(), headerSize, Exiv2::ErrorCode::kerCorruptedMetadata);
+    io_->seek(offset + size_u32 + size_u32 % 2, BasicIo::beg);
 
     /* Chunk with information about features
      used in the file. */
@@ -178,12 +210,12 @@ void WebPImage::doWriteMetadata(BasicIo& outIo) {
       byte size_buf[WEBP_TAG_SIZE];
 
       // Fetch width - stored in 24bits
-      memcpy(&size_buf, payload.c_data(4), 3);
+      memcpy(&size_buf, payloadHead.c_data(4), 3);
       size_buf[3] = 0;
       width = Exiv2::getULong(size_buf, littleEndian) + 1;
 
       // Fetch height - stored in 24bits
-      memcpy(&size_buf, payload.c_data(7), 3);
+      memcpy(&size_buf, payloadHead.c_data(7), 3);
       size_buf[3] = 0;
       height = Exiv2::getULong(size_buf, littleEndian) + 1;
     }
@@ -210,18 +242,18 @@ void WebPImage::doWriteMetadata(BasicIo& outIo) {
          for height and width reference for VP8 chunks */
 
       // Fetch width - stored in 16bits
-      memcpy(&size_buf, payload.c_data(6), 2);
+      memcpy(&size_buf, payloadHead.c_data(6), 2);
       width = Exiv2::getUShort(size_buf, littleEndian) & 0x3fff;
 
       // Fetch height - stored in 16bits
-      memcpy(&size_buf, payload.c_data(8), 2);
+      memcpy(&size_buf, payloadHead.c_data(8), 2);
       height = Exiv2::getUShort(size_buf, littleEndian) & 0x3fff;
     }
 
     /* Chunk with lossless image data. */
     if (equalsWebPTag(chunkId, WEBP_CHUNK_HEADER_VP8L) && !has_alpha) {
       enforce(size_u32 >= 5, Exiv2::ErrorCode::kerCorruptedMetadata);
-      if ((payload.read_uint8(4) & WEBP_VP8X_ALPHA_BIT) == WEBP_VP8X_ALPHA_BIT) {
+      if ((payloadHead.read_uint8(4) & WEBP_VP8X_ALPHA_BIT) == WEBP_VP8X_ALPHA_BIT) {
         has_alpha = true;
       }
     }
@@ -237,12 +269,12 @@ void WebPImage::doWriteMetadata(BasicIo& outIo) {
          each. Refer to this https://goo.gl/bpgMJf */
 
       // Fetch width - 14 bits wide
-      memcpy(&size_buf_w, payload.c_data(1), 2);
+      memcpy(&size_buf_w, payloadHead.c_data(1), 2);
       size_buf_w[1] &= 0x3F;
       width = Exiv2::getUShort(size_buf_w, littleEndian) + 1;
 
       // Fetch height - 14 bits wide
-      memcpy(&size_buf_h, payload.c_data(2), 3);
+      memcpy(&size_buf_h, payloadHead.c_data(2), 3);
       size_buf_h[0] = ((size_buf_h[0] >> 6) & 0x3) | ((size_buf_h[1] & 0x3FU) << 0x2);
       size_buf_h[1] = ((size_buf_h[1] >> 6) & 0x3) | ((size_buf_h[2] & 0xFU) << 0x2);
       height = Exiv2::getUShort(size_buf_h, littleEndian) + 1;
@@ -251,7 +283,7 @@ void WebPImage::doWriteMetadata(BasicIo& outIo) {
     /* Chunk with animation frame. */
     if (equalsWebPTag(chunkId, WEBP_CHUNK_HEADER_ANMF) && !has_alpha) {
       enforce(size_u32 >= 6, Exiv2::ErrorCode::kerCorruptedMetadata);
-      if ((payload.read_uint8(5) & 0x2) == 0x2) {
+      if ((payloadHead.read_uint8(5) & 0x2) == 0x2) {
         has_alpha = true;
       }
     }
@@ -261,12 +293,12 @@ void WebPImage::doWriteMetadata(BasicIo& outIo) {
       byte size_buf[WEBP_TAG_SIZE];
 
       // Fetch width - stored in 24bits
-      memcpy(&size_buf, payload.c_data(6), 3);
+      memcpy(&size_buf, payloadHead.c_data(6), 3);
       size_buf[3] = 0;
       width = Exiv2::getULong(size_buf, littleEndian) + 1;
 
       // Fetch height - stored in 24bits
-      memcpy(&size_buf, payload.c_data(9), 3);
+      memcpy(&size_buf, payloadHead.c_data(9), 3);
       size_buf[3] = 0;
       height = Exiv2::getULong(size_buf, littleEndian) + 1;
     }
@@ -282,19 +314,17 @@ void WebPImage::doWriteMetadata(BasicIo& outIo) {
     inject_VP8X(outIo, has_xmp, has_exif, has_alpha, has_icc, width, height);
   }
 
-  io_->seek(12, BasicIo::beg);
-  while (!io_->eof() && io_->tell() < filesize) {
-    io_->readOrThrow(chunkId.data(), 4, Exiv2::ErrorCode::kerCorruptedMetadata);
-    io_->readOrThrow(size_buff, 4, Exiv2::ErrorCode::kerCorruptedMetadata);
-
-    const uint32_t size_u32 = Exiv2::getULong(size_buff, littleEndian);
-    DataBuf payload(size_u32);
-    io_->readOrThrow(payload.data(), size_u32, Exiv2::ErrorCode::kerCorruptedMetadata);
-    if (io_->tell() % 2)
-      io_->seek(+1, BasicIo::cur);  // skip pad
+  DataBuf copyBuf;
+  for (const auto& chunk : chunks) {
+    std::copy_n(chunk.id, WEBP_TAG_SIZE, chunkId.begin());
+    const uint32_t size_u32 = chunk.size;
+    ul2Data(size_buff, size_u32, littleEndian);
+    io_->seek(chunk.offset, BasicIo::beg);
 
     if (equalsWebPTag(chunkId, WEBP_CHUNK_HEADER_VP8X)) {
       enforce(size_u32 >= 1, Exiv2::ErrorCode::kerCorruptedMetadata);
+      DataBuf payload(size_u32);
+      io_->readOrThrow(payload.data(), payload.size(), Exiv2::ErrorCode::kerCorruptedMetadata);
       if (has_icc) {
         const uint8_t x = payload.read_uint8(0);
         payload.write_uint8(0, x | WEBP_VP8X_ICC_BIT);
@@ -350,8 +380,9 @@ void WebPImage::doWriteMetadata(BasicIo& outIo) {
         throw Error(ErrorCode::kerImageWriteFailed);
       if (outIo.write(size_buff, WEBP_TAG_SIZE) != WEBP_TAG_SIZE)
         throw Error(ErrorCode::kerImageWriteFailed);
-      if (outIo.write(payload.c_data(), payload.size()) != payload.size())
-        throw Error(ErrorCode::kerImageWriteFailed);
+      if (copyBuf.empty())
+        copyBuf.alloc(64 * 1024);
+      copyBytes(*io_, outIo, size_u32, copyBuf);
     }
 
     // Encoder required to pad odd sized data with a null byte
@@ -459,6 +490,7 @@ void WebPImage::printStructure(std::ostream& out, PrintStructureOption option, s
 /* =========================================== */
 
 void WebPImage::readMetadata() {
+  EXV_STATS_SCOPE("WebPImage::readMetadata");
   if (io_->open() != 0)
     throw Error(ErrorCode::kerDataSourceOpenFailed, io_->path(), strError());
   IoCloser closer(*io_);
@@ -503,9 +535,9 @@ void WebPImage::decodeChunks(uint32_t filesize) {
     enforce(io_->tell() <= filesize, Exiv2::ErrorCode::kerCorruptedMetadata);
     enforce(size <= (filesize - io_->tell()), Exiv2::ErrorCode::kerCorruptedMetadata);
 
-    DataBuf payload(size);
+    DataBuf payload;
 
-    if (payload.empty()) {
+    if (size == 0) {
       io_->seek(size, BasicIo::cur);
     } else if (equalsWebPTag(chunkId, WEBP_CHUNK_HEADER_VP8X) && !has_canvas_data) {
       enforce(size >= 10, Exiv2::ErrorCode::kerCorruptedMetadata);
@@ -513,7 +545,9 @@ void WebPImage::decodeChunks(uint32_t filesize) {
       has_canvas_data = true;
       byte size_buf[WEBP_TAG_SIZE];
 
+      payload.alloc(std::min(size, canvasHeaderSize));
       io_->readOrThrow(payload.data(), payload.size(), Exiv2::ErrorCode::kerCorruptedMetadata);
+      io_->seek(size - payload.size(), BasicIo::cur);
 
       // Fetch width
       memcpy(&size_buf, payload.c_data(4), 3);
@@ -528,7 +562,9 @@ void WebPImage::decodeChunks(uint32_t filesize) {
       enforce(size >= 10, Exiv2::ErrorCode::kerCorruptedMetadata);
 
       has_canvas_data = true;
+      payload.alloc(std::min(size, canvasHeaderSize));
       io_->readOrThrow(payload.data(), payload.size(), Exiv2::ErrorCode::kerCorruptedMetadata);
+      io_->seek(size - payload.size(), BasicIo::cur);
       byte size_buf[WEBP_TAG_SIZE];
 
       // Fetch width""
@@ -549,7 +585,9 @@ void WebPImage::decodeChunks(uint32_t filesize) {
       byte size_buf_w[2];
       byte size_buf_h[3];
 
+      payload.alloc(std::min(size, canvasHeaderSize));
       io_->readOrThrow(payload.data(), payload.size(), Exiv2::ErrorCode::kerCorruptedMetadata);
+      io_->seek(size - payload.size(), BasicIo::cur);
 
       // Fetch width
       memcpy(&size_buf_w, payload.c_data(1), 2);
@@ -567,7 +605,9 @@ void WebPImage::decodeChunks(uint32_t filesize) {
       has_canvas_data = true;
       byte size_buf[WEBP_TAG_SIZE];
 
+      payload.alloc(std::min(size, canvasHeaderSize));
       io_->readOrThrow(payload.data(), payload.size(), Exiv2::ErrorCode::kerCorruptedMetadata);
+      io_->seek(size - payload.size(), BasicIo::cur);
 
       // Fetch width
       memcpy(&size_buf, payload.c_data(6), 3);
@@ -579,9 +619,11 @@ void WebPImage::decodeChunks(uint32_t filesize) {
       size_buf[3] = 0;
       pixelHeight_ = Exiv2::getULong(size_buf, littleEndian) + 1;
     } else if (equalsWebPTag(chunkId, WEBP_CHUNK_HEADER_ICCP)) {
+      payload.alloc(size);
       io_->readOrThrow(payload.data(), payload.size(), Exiv2::ErrorCode::kerCorruptedMetadata);
       this->setIccProfile(std::move(payload));
     } else if (equalsWebPTag(chunkId, WEBP_CHUNK_HEADER_EXIF)) {
+      payload.alloc(size);
       io_->readOrThrow(payload.data(), payload.size(), Exiv2::ErrorCode::kerCorruptedMetadata);
 
       byte size_buff2[2];
@@ -656,6 +698,7 @@ void WebPImage::decodeChunks(uint32_t filesize) {
         exifData_.clear();
       }
     } else if (equalsWebPTag(chunkId, WEBP_CHUNK_HEADER_XMP)) {
+      payload.alloc(size);
       io_->readOrThrow(payload.data(), payload.size(), Exiv2::ErrorCode::kerCorruptedMetadata);
       xmpPacket_.assign(payload.c_str(), payload.size());
       if (!xmpPacket_.empty() && XmpParser::decode(xmpData_, xmpPacket_)) {
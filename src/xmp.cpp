@@ -3,6 +3,7 @@
 // included header files
 #include "error.hpp"
 #include "properties.hpp"
+#include "stats_int.hpp"
 #include "types.hpp"
 #include "utils.hpp"
 #include "value.hpp"
@@ -11,6 +12,7 @@
 // + standard includes
 #include <algorithm>
 #include <iostream>
+#include <mutex>
 
 // Adobe XMP Toolkit
 #ifdef EXV_HAVE_XMP_TOOLKIT
@@ -249,6 +251,9 @@ class AutoLock {
   Exiv2::XmpParser::XmpLockFct xmpLockFct_;
   void* pLockData_;
 };
+
+//! Serializes the initialization and termination of the XMP Toolkit
+std::mutex xmpInitMutex;
 }  // namespace
 
 // *****************************************************************************
@@ -421,10 +426,13 @@ int Xmpdatum::setValue(const std::string& value) {
 }
 
 Xmpdatum& XmpData::operator[](const std::string& key) {
-  XmpKey xmpKey(key);
-  auto pos = findKey(xmpKey);
+  return operator[](XmpKey(key));
+}
+
+Xmpdatum& XmpData::operator[](const XmpKey& key) {
+  auto pos = findKey(key);
   if (pos == end()) {
-    xmpMetadata_.push_back(Xmpdatum(xmpKey));
+    xmpMetadata_.emplace_back(key);
     return xmpMetadata_.back();
   }
   return *pos;
@@ -506,16 +514,74 @@ void XmpData::eraseFamily(XmpData::iterator& pos) {
   }
 }
 
-bool XmpParser::initialized_ = false;
+XmpDataBuilder::XmpDataBuilder(XmpData& xmpData) : xmpData_(xmpData) {
+}
+
+const XmpKey& XmpDataBuilder::xmpKey(const std::string& key) {
+  auto pos = keys_.find(key);
+  if (pos == keys_.end())
+    pos = keys_.emplace(key, XmpKey(key)).first;
+  return pos->second;
+}
+
+Xmpdatum& XmpDataBuilder::operator[](const std::string& key) {
+  added_.push_back(xmpData_.xmpMetadata_.size());
+  return xmpData_.xmpMetadata_.emplace_back(xmpKey(key));
+}
+
+void XmpDataBuilder::finish() {
+  auto& metadata = xmpData_.xmpMetadata_;
+
+  // Assign the value of each repeated key to its first occurrence
+  std::map<std::string, size_t> first;
+  std::vector<bool> merged(metadata.size());
+  size_t out = metadata.size();
+  for (size_t i : added_) {
+    if (i >= metadata.size())
+      continue;
+    auto [pos, inserted] = first.try_emplace(metadata[i].key(), i);
+    if (!inserted) {
+      metadata[pos->second] = metadata[i];
+      merged[i] = true;
+      out = std::min(out, i);
+    }
+  }
+  added_.clear();
+
+  // Close the gaps left by the merged entries
+  for (size_t i = out; i < metadata.size(); ++i) {
+    if (merged[i])
+      continue;
+    metadata[out] = metadata[i];
+    ++out;
+  }
+  metadata.erase(metadata.begin() + out, metadata.end());
+}
+
+XmpDataFinisher::~XmpDataFinisher() {
+  try {
+    builder_.finish();
+  } catch (const std::exception& e) {
+#ifndef SUPPRESS_WARNINGS
+    EXV_WARNING << "Failed to merge XMP properties: " << e.what() << "\n";
+#endif
+  }
+}
+
+std::atomic<bool> XmpParser::initialized_ = false;
 XmpParser::XmpLockFct XmpParser::xmpLockFct_ = nullptr;
 void* XmpParser::pLockData_ = nullptr;
 
 #ifdef EXV_HAVE_XMP_TOOLKIT
 bool XmpParser::initialize(XmpParser::XmpLockFct xmpLockFct, void* pLockData) {
+  if (initialized_)
+    return true;
+  auto scopedLock = std::scoped_lock(xmpInitMutex);
   if (!initialized_) {
     xmpLockFct_ = xmpLockFct;
     pLockData_ = pLockData;
-    initialized_ = SXMPMeta::Initialize();
+    // publish initialized_ only once the namespaces below are registered
+    const bool initialized = SXMPMeta::Initialize();
 #ifdef EXV_ADOBE_XMPSDK
     SXMPMeta::RegisterNamespace("http://ns.adobe.com/lightroom/1.0/", "lr", nullptr);
     SXMPMeta::RegisterNamespace("http://rs.tdwg.org/dwc/index.htm", "dwc", nullptr);
@@ -563,6 +629,7 @@ bool XmpParser::initialize(XmpParser::XmpLockFct xmpLockFct, void* pLockData) {
     SXMPMeta::RegisterNamespace("http://www.audio/", "audio");
     SXMPMeta::RegisterNamespace("http://www.video/", "video");
 #endif
+    initialized_ = initialized;
   }
   return initialized_;
 }
@@ -627,6 +694,7 @@ void XmpParser::registeredNamespaces(Exiv2::Dictionary&) {
 
 void XmpParser::terminate() {
   XmpProperties::unregisterNs();
+  auto scopedLock = std::scoped_lock(xmpInitMutex);
   if (initialized_) {
 #ifdef EXV_HAVE_XMP_TOOLKIT
     SXMPMeta::Terminate();
@@ -669,6 +737,7 @@ void XmpParser::unregisterNs(const std::string& /*ns*/) {
 
 #ifdef EXV_HAVE_XMP_TOOLKIT
 int XmpParser::decode(XmpData& xmpData, const std::string& xmpPacket) {
+  EXV_STATS_SCOPE("XmpParser::decode");
   try {
     xmpData.clear();
     xmpData.setPacket(xmpPacket);
@@ -811,6 +880,7 @@ int XmpParser::decode(XmpData& xmpData, const std::string& xmpPacket) {
 
 #ifdef EXV_HAVE_XMP_TOOLKIT
 int XmpParser::encode(std::string& xmpPacket, const XmpData& xmpData, uint16_t formatFlags, uint32_t padding) {
+  EXV_STATS_SCOPE("XmpParser::encode");
   try {
     if (xmpData.empty()) {
       xmpPacket.clear();
@@ -7,6 +7,7 @@
 #include "error.hpp"
 #include "futils.hpp"
 #include "image.hpp"
+#include "stats_int.hpp"
 #include "utils.hpp"
 #include "xmp_exiv2.hpp"
 
@@ -37,6 +38,7 @@ void XmpSidecar::setComment(const std::string&) {
 }
 
 void XmpSidecar::readMetadata() {
+  EXV_STATS_SCOPE("XmpSidecar::readMetadata");
 #ifdef EXIV2_DEBUG_MESSAGES
   std::cerr << "Reading XMP file " << io_->path() << "\n";
 #endif
@@ -86,6 +88,7 @@ static bool matchi(const std::string& key, const char* substr) {
 }
 
 void XmpSidecar::writeMetadata() {
+  EXV_STATS_SCOPE("XmpSidecar::writeMetadata");
   if (io_->open() != 0) {
     throw Error(ErrorCode::kerDataSourceOpenFailed, io_->path(), strError());
   }
@@ -2,6 +2,17 @@
 
 #include <gtest/gtest.h>
 #include "basicio.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+#if defined(__linux__) && defined(EXV_HAVE_SYS_XATTR_H)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/xattr.h>
+#endif
+
 using namespace Exiv2;
 
 namespace {
@@ -51,6 +62,81 @@ TEST(AFileIO, returnsFileSizeEvenWhenFileItIsNotOpened) {
   ASSERT_EQ(118685UL, file.size());
 }
 
+TEST(AFileIO, returnsUpdatedFileSizeAfterWritingToTheOpenFile) {
+  const std::string path("AFileIO_size.bin");
+  FileIo file(path);
+  ASSERT_EQ(0, file.open("w+b"));
+  ASSERT_EQ(0UL, file.size());
+  const byte data[] = {1, 2, 3, 4, 5, 6, 7, 8};
+  ASSERT_EQ(sizeof(data), file.write(data, sizeof(data)));
+  ASSERT_EQ(sizeof(data), file.size());
+  file.close();
+  ASSERT_EQ(sizeof(data), file.size());
+  std::remove(path.c_str());
+}
+
+TEST(AFileIO, transferFromMemIoReplacesTheContents) {
+  const std::string path("AFileIO_transfer.bin");
+  FileIo file(path);
+  ASSERT_EQ(0, file.open("w+b"));
+  const byte oldData[] = {1, 2, 3, 4, 5, 6, 7, 8};
+  ASSERT_EQ(sizeof(oldData), file.write(oldData, sizeof(oldData)));
+  file.close();
+
+  const byte newData[] = {9, 8, 7};
+  MemIo src(newData, sizeof(newData));
+  file.transfer(src);
+  ASSERT_FALSE(file.isopen());
+  ASSERT_EQ(sizeof(newData), file.size());
+
+  byte buf[sizeof(oldData)] = {};
+  ASSERT_EQ(0, file.open());
+  ASSERT_EQ(sizeof(newData), file.read(buf, sizeof(buf)));
+  ASSERT_EQ(0, std::memcmp(buf, newData, sizeof(newData)));
+  file.close();
+  std::remove(path.c_str());
+}
+
+#if defined(__linux__) && defined(EXV_HAVE_SYS_XATTR_H)
+TEST(AFileIO, transferFromMemIoKeepsTheAttributesOfTheFile) {
+  const std::string path("AFileIO_attributes.bin");
+  FileIo file(path);
+  ASSERT_EQ(0, file.open("w+b"));
+  const byte oldData[] = {1, 2, 3, 4, 5, 6, 7, 8};
+  ASSERT_EQ(sizeof(oldData), file.write(oldData, sizeof(oldData)));
+  file.close();
+
+  const char tag[] = "exiv2";
+  if (::setxattr(path.c_str(), "user.tag", tag, sizeof(tag), 0) != 0) {
+    std::remove(path.c_str());
+    GTEST_SKIP() << "the file system has no user extended attributes";
+  }
+  ASSERT_EQ(0, ::chmod(path.c_str(), 0640));
+  const struct timespec times[2] = {{1000000000, 0}, {1000000000, 0}};
+  ASSERT_EQ(0, ::utimensat(AT_FDCWD, path.c_str(), times, 0));
+
+  const byte newData[] = {9, 8, 7};
+  MemIo src(newData, sizeof(newData));
+  file.transfer(src);
+  ASSERT_EQ(sizeof(newData), file.size());
+
+  struct stat st;
+  ASSERT_EQ(0, ::stat(path.c_str(), &st));
+  ASSERT_EQ(0640u, st.st_mode & 07777);
+  ASSERT_EQ(1000000000, st.st_atim.tv_sec);
+  ASSERT_NE(1000000000, st.st_mtim.tv_sec);
+  char value[sizeof(tag)] = {};
+  ASSERT_EQ(static_cast<ssize_t>(sizeof(tag)), ::getxattr(path.c_str(), "user.tag", value, sizeof(value)));
+  ASSERT_STREQ(tag, value);
+
+  // the temporary file is gone
+  for (const auto& entry : std::filesystem::directory_iterator(".")) {
+    ASSERT_EQ(std::string::npos, entry.path().filename().string().find(path + ".exiv2-"));
+  }
+  std::remove(path.c_str());
+}
+#endif
+
 TEST(AFileIO, isOpenedAtPosition0) {
   FileIo file(imagePath);
   file.open();
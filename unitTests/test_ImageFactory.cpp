@@ -2,6 +2,7 @@
 
 #include <image.hpp>  // Unit under test
 
+#include <basicio.hpp>
 #include <error.hpp>  // Need to include this header for the Exiv2::Error exception
 
 #include <gtest/gtest.h>
@@ -10,6 +11,25 @@
 using namespace Exiv2;
 namespace fs = std::filesystem;
 
+namespace {
+//! MemIo that counts the reads issued against it
+class CountingMemIo : public MemIo {
+ public:
+  using MemIo::MemIo;
+
+  DataBuf read(size_t rcount) override {
+    ++reads_;
+    return MemIo::read(rcount);
+  }
+  size_t read(byte* buf, size_t rcount) override {
+    ++reads_;
+    return MemIo::read(buf, rcount);
+  }
+
+  size_t reads_{0};
+};
+}  // namespace
+
 TEST(TheImageFactory, createsInstancesForFewSupportedTypesInMemory) {
   // Note that the constructor of these Image classes take an 'create' argument
   EXPECT_NO_THROW(ImageFactory::create(ImageType::jp2));
@@ -135,6 +155,66 @@ TEST(TheImageFactory, loadInstancesDifferentImageTypes) {
   EXPECT_NO_THROW(ImageFactory::open(imagePath, false));
 }
 
+TEST(TheImageFactory, readsTheHeaderOnceToFindTheType) {
+  // JPEG 2000 comes late in the registry, only its own type check confirms the header
+  const DataBuf jp2 = readFile((fs::path(TESTDATA_PATH) / "Reagan.jp2").string());
+  CountingMemIo io(jp2.c_data(), jp2.size());
+  EXPECT_EQ(ImageType::jp2, ImageFactory::getType(io));
+  EXPECT_EQ(2u, io.reads_);
+
+  const byte unknown[] = "no image starts with these bytes, not even a TIFF or a RIFF file";
+  CountingMemIo unknownIo(unknown, sizeof(unknown));
+  EXPECT_EQ(ImageType::none, ImageFactory::getType(unknownIo));
+  EXPECT_EQ(1u, unknownIo.reads_);
+}
+
+TEST(TheImageFactory, confirmsMagicNumbersWithTheTypeCheck) {
+  // "II" starts every TIFF based format, the type checks still reject the rest of the header
+  const byte notTiff[] = "II not a TIFF header, just text";
+  EXPECT_EQ(ImageType::none, ImageFactory::getType(notTiff, sizeof(notTiff)));
+
+  // a truncated JPEG 2000 signature box is recognized from its magic number
+  const byte jp2Head[] = {0x00, 0x00, 0x00, 0x0c, 0x6a, 0x50, 0x20, 0x20, 0x0d, 0x0a,
+                          0x87, 0x0a, 0x00, 0x00, 0x00, 0x08, 0x6a, 0x70, 0x32, 0x68};
+  EXPECT_EQ(ImageType::jp2, ImageFactory::getType(jp2Head, sizeof(jp2Head)));
+}
+
+TEST(AReopenedImage, readsTheSameMetadataAsANewImage) {
+  const std::string first = (fs::path(TESTDATA_PATH) / "Reagan.jpg").string();
+  const std::string second = (fs::path(TESTDATA_PATH) / "DSC_3079.jpg").string();
+
+  auto fresh = ImageFactory::open(second);
+  fresh->readMetadata();
+
+  auto image = ImageFactory::open(first);
+  image->readMetadata();
+  const BasicIo* io = &image->io();
+  image->reopen(second);
+  ASSERT_EQ(io, &image->io());  // the FileIo is reused
+  ASSERT_EQ(second, image->io().path());
+  ASSERT_TRUE(image->exifData().empty());
+  ASSERT_TRUE(image->xmpPacket().empty());
+
+  image->readMetadata();
+  ASSERT_EQ(fresh->exifData().count(), image->exifData().count());
+  ASSERT_EQ(fresh->iptcData().count(), image->iptcData().count());
+  ASSERT_EQ(fresh->xmpData().count(), image->xmpData().count());
+  ASSERT_EQ(fresh->pixelWidth(), image->pixelWidth());
+  ASSERT_EQ(fresh->exifData()["Exif.Image.Model"].toString(), image->exifData()["Exif.Image.Model"].toString());
+}
+
+TEST(AReopenedImage, rejectsAFileOfAnotherTypeWhenReading) {
+  auto image = ImageFactory::open((fs::path(TESTDATA_PATH) / "Reagan.jpg").string());
+  image->readMetadata();
+  image->reopen((fs::path(TESTDATA_PATH) / "exiv2-bug1074.png").string());
+  ASSERT_THROW(image->readMetadata(), Error);
+
+  const DataBuf jpeg = readFile((fs::path(TESTDATA_PATH) / "Reagan.jpg").string());
+  image->reopen(std::make_unique<MemIo>(jpeg.c_data(), jpeg.size()));
+  ASSERT_NO_THROW(image->readMetadata());
+  ASSERT_FALSE(image->exifData().empty());
+}
+
 TEST(TheImageFactory, getsExpectedModesForJp2Images) {
   EXPECT_EQ(amNone, ImageFactory::checkMode(ImageType::jp2, mdNone));
   EXPECT_EQ(amReadWrite, ImageFactory::checkMode(ImageType::jp2, mdExif));
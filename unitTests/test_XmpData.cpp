@@ -0,0 +1,73 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <gtest/gtest.h>
+#include <exiv2/xmp_exiv2.hpp>
+
+using namespace Exiv2;
+
+TEST(XmpData, subscriptWithParsedKeyAddsOnlyOnce) {
+  XmpData xmpData;
+  const XmpKey key("Xmp.video.Width");
+  xmpData[key] = 640;
+  xmpData[key] = 1280;
+  ASSERT_EQ(1, xmpData.count());
+  ASSERT_EQ(1280, xmpData["Xmp.video.Width"].toInt64());
+}
+
+TEST(XmpDataBuilder, finishMergesRepeatedKeysLikeSubscript) {
+  XmpData expected;
+  expected["Xmp.video.Width"] = 640;
+  expected["Xmp.video.Height"] = 480;
+  expected["Xmp.video.Width"] = 1280;
+  expected["Xmp.audio.SampleRate"] = 44100;
+
+  XmpData xmpData;
+  XmpDataBuilder builder(xmpData);
+  builder["Xmp.video.Width"] = 640;
+  builder["Xmp.video.Height"] = 480;
+  builder["Xmp.video.Width"] = 1280;
+  builder["Xmp.audio.SampleRate"] = 44100;
+  ASSERT_EQ(4, xmpData.count());
+
+  builder.finish();
+  ASSERT_EQ(expected.count(), xmpData.count());
+  auto pos = xmpData.begin();
+  for (const auto& xmp : expected) {
+    ASSERT_EQ(xmp.key(), pos->key());
+    ASSERT_EQ(xmp.toString(), pos->toString());
+    ++pos;
+  }
+}
+
+TEST(XmpDataBuilder, finishKeepsPropertiesAddedToTheContainerDirectly) {
+  XmpData xmpData;
+  xmpData["Xmp.video.Width"] = 320;
+  XmpDataBuilder builder(xmpData);
+  builder["Xmp.video.Width"] = 640;
+  const XmpKey key("Xmp.video.CompatibleBrands");
+  XmpTextValue value("isom");
+  xmpData.add(key, &value);
+  builder["Xmp.video.Width"] = 1280;
+  value.read("mp42");
+  xmpData.add(key, &value);
+
+  builder.finish();
+  ASSERT_EQ(4, xmpData.count());
+  auto pos = xmpData.begin();
+  ASSERT_EQ("320", (pos++)->toString());
+  ASSERT_EQ("1280", (pos++)->toString());
+  ASSERT_EQ("isom", (pos++)->toString());
+  ASSERT_EQ("mp42", pos->toString());
+}
+
+TEST(XmpDataBuilder, finishWithoutRepeatedKeysKeepsEverything) {
+  XmpData xmpData;
+  XmpDataBuilder builder(xmpData);
+  builder["Xmp.video.Width"] = 640;
+  builder["Xmp.video.Height"] = 480;
+  builder.finish();
+  builder.finish();
+  ASSERT_EQ(2, xmpData.count());
+  ASSERT_EQ("640", xmpData["Xmp.video.Width"].toString());
+  ASSERT_EQ("480", xmpData["Xmp.video.Height"].toString());
+}
@@ -3,6 +3,7 @@
 #include <gtest/gtest.h>
 
 #include <array>
+#include <vector>
 #include <exiv2/asfvideo.hpp>
 
 using namespace Exiv2;
@@ -52,4 +53,40 @@ TEST(AsfVideo, readMetadata) {
   auto data = asf.xmpData();
   ASSERT_FALSE(data.empty());
   ASSERT_EQ(xmpData["Xmp.video.TotalStream"].count(), 4);
-}
\ No newline at end of file
+}
+
+TEST(AsfVideo, readMetadataDecodesVideoStreamProperties) {
+  const std::array<byte, 16> header{0x30, 0x26, 0xb2, 0x75, 0x8e, 0x66, 0xcf, 0x11,
+                                    0xa6, 0xd9, 0x00, 0xaa, 0x00, 0x62, 0xce, 0x6c};
+  const std::array<byte, 16> streamProperties{0x91, 0x07, 0xdc, 0xb7, 0xb7, 0xa9, 0xcf, 0x11,
+                                              0x8e, 0xe6, 0x00, 0xc0, 0x0c, 0x20, 0x53, 0x65};
+  const std::array<byte, 16> videoMedia{0xc0, 0xef, 0x19, 0xbc, 0x4d, 0x5b, 0xcf, 0x11,
+                                        0xa8, 0xfd, 0x00, 0x80, 0x5f, 0x5c, 0x44, 0x2b};
+  std::vector<byte> file;
+  auto put = [&file](uint64_t value, size_t size) {
+    for (size_t i = 0; i < size; ++i)
+      file.push_back(static_cast<byte>(value >> (8 * i)));
+  };
+
+  // Header object with a single Stream Properties object for a 640x480 video stream
+  const size_t streamSize = 24 + 16 + 16 + 8 + 4 + 4 + 2 + 4 + 4 + 4 + 1 + 2 + 40;
+  file.insert(file.end(), header.begin(), header.end());
+  put(30 + streamSize, 8);
+  put(1, 4);
+  put(0x0201, 2);
+  file.insert(file.end(), streamProperties.begin(), streamProperties.end());
+  put(streamSize, 8);
+  file.insert(file.end(), videoMedia.begin(), videoMedia.end());
+  file.insert(file.end(), 16, 0);  // error correction type
+  put(0, 8);                       // time offset
+  put(0, 4 + 4 + 2 + 4);           // data lengths, flags, reserved
+  put(640, 4);
+  put(480, 4);
+  put(0, 1 + 2 + 40);
+
+  AsfVideo asf(std::make_unique<MemIo>(file.data(), file.size()));
+  ASSERT_NO_THROW(asf.readMetadata());
+  ASSERT_EQ(asf.xmpData()["Xmp.video.Width"].toInt64(), 640);
+  ASSERT_EQ(asf.xmpData()["Xmp.video.Height"].toInt64(), 480);
+  ASSERT_EQ(asf.xmpData()["Xmp.video.AspectRatio"].toString(), "4:3");
+}
@@ -3,7 +3,9 @@
 #include <gtest/gtest.h>
 #include <exiv2/basicio.hpp>
 
+#include <algorithm>
 #include <array>
+#include <cstdio>
 
 using namespace Exiv2;
 
@@ -179,3 +181,38 @@ TEST(MemIo, readMoreBytesThanAvailableReturnsAvailableBytes) {
   MemIo io(buf1.data(), buf1.size());
   ASSERT_EQ(10, io.read(buf2.data(), 15));
 }
+
+TEST(MemIo, writeFromAnotherIoCopiesTheRemainingData) {
+  std::array<byte, 10> buf1;
+  for (size_t i = 0; i < buf1.size(); ++i)
+    buf1[i] = static_cast<byte>(i);
+
+  MemIo src(buf1.data(), buf1.size());
+  ASSERT_EQ(0, src.seek(3, BasicIo::beg));
+  MemIo io;
+  ASSERT_EQ(7, io.write(src));
+  ASSERT_EQ(7, io.size());
+  ASSERT_EQ(7, io.tell());
+  ASSERT_TRUE(std::equal(buf1.begin() + 3, buf1.end(), io.mmap()));
+  ASSERT_EQ(0, io.write(src));
+}
+
+TEST(FileIo, writeFromMemIoCopiesTheRemainingData) {
+  std::array<byte, 10> buf1, buf2;
+  for (size_t i = 0; i < buf1.size(); ++i)
+    buf1[i] = static_cast<byte>(i);
+  buf2.fill(0);
+
+  MemIo src(buf1.data(), buf1.size());
+  ASSERT_EQ(0, src.seek(4, BasicIo::beg));
+  const std::string path("FileIo_writeFromMemIo.bin");
+  FileIo file(path);
+  ASSERT_EQ(0, file.open("w+b"));
+  ASSERT_EQ(6, file.write(src));
+  ASSERT_EQ(10, src.tell());
+  ASSERT_EQ(0, file.seek(0, BasicIo::beg));
+  ASSERT_EQ(6, file.read(buf2.data(), buf2.size()));
+  ASSERT_TRUE(std::equal(buf1.begin() + 4, buf1.end(), buf2.begin()));
+  file.close();
+  std::remove(path.c_str());
+}
@@ -0,0 +1,116 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <exiv2/bmffimage.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace Exiv2;
+namespace fs = std::filesystem;
+
+namespace {
+class BmffImageTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    enableBMFF(true);
+  }
+  void TearDown() override {
+    enableBMFF(false);
+  }
+};
+
+std::string printStructure(size_t maxDepth) {
+  BmffImage image(std::make_unique<FileIo>((fs::path(TESTDATA_PATH) / "avif.avif").string()), false);
+  PrintStructureLimits limits;
+  limits.maxDepth_ = maxDepth;
+  image.setPrintStructureLimits(limits);
+  std::ostringstream out;
+  image.printStructure(out, kpsBasic, 1);
+  return out.str();
+}
+
+#if defined(EXV_HAVE_BROTLI) && defined(EXV_HAVE_XMP_TOOLKIT)
+//! Brotli stream which stores data in uncompressed meta-blocks (RFC 7932, 9.2)
+std::vector<byte> brotliStore(const std::string& data) {
+  std::vector<byte> stream;
+  size_t pos = 0;
+  do {
+    const size_t length = std::min<size_t>(data.size() - pos, 0x10000);
+    // ISLAST 0, MNIBBLES 4, MLEN - 1, ISUNCOMPRESSED 1, after the WBITS 16 bit of the stream header
+    const uint32_t bits = ((static_cast<uint32_t>(length - 1) << 3) | (1u << 19)) << (pos == 0 ? 1 : 0);
+    for (int i = 0; i < 3; ++i)
+      stream.push_back(static_cast<byte>(bits >> (8 * i)));
+    stream.insert(stream.end(), data.begin() + pos, data.begin() + pos + length);
+    pos += length;
+  } while (pos < data.size());
+  stream.push_back(0x03);  // ISLAST 1, ISLASTEMPTY 1
+  return stream;
+}
+
+void appendBox(std::vector<byte>& file, const char* type, const std::vector<byte>& payload) {
+  const auto size = static_cast<uint32_t>(8 + payload.size());
+  for (int shift = 24; shift >= 0; shift -= 8)
+    file.push_back(static_cast<byte>(size >> shift));
+  file.insert(file.end(), type, type + 4);
+  file.insert(file.end(), payload.begin(), payload.end());
+}
+
+//! JPEG XL file with an XMP packet in a brob box
+std::vector<byte> jxlWithBrotliXmp(const std::string& format) {
+  const std::string xmp =
+      "<?xpacket begin=\"\" id=\"W5M0MpCehiHzreSzNTczkc9d\"?><x:xmpmeta xmlns:x=\"adobe:ns:meta/\">"
+      "<rdf:RDF xmlns:rdf=\"http://www.w3.org/1999/02/22-rdf-syntax-ns#\"><rdf:Description rdf:about=\"\" "
+      "xmlns:dc=\"http://purl.org/dc/elements/1.1/\" dc:format=\"" +
+      format + "\"/></rdf:RDF></x:xmpmeta><?xpacket end=\"w\"?>";
+  std::vector<byte> file;
+  appendBox(file, "JXL ", {0x0d, 0x0a, 0x87, 0x0a});
+  appendBox(file, "ftyp", {'j', 'x', 'l', ' ', 0, 0, 0, 0, 'j', 'x', 'l', ' '});
+  std::vector<byte> brob = {'x', 'm', 'l', ' '};
+  const auto stream = brotliStore(xmp);
+  brob.insert(brob.end(), stream.begin(), stream.end());
+  appendBox(file, "brob", brob);
+  return file;
+}
+#endif
+}  // namespace
+
+TEST_F(BmffImageTest, printStructureHonoursTheDepthLimitBelowTheTopLevel) {
+  const std::string top = printStructure(0);
+  ASSERT_NE(std::string::npos, top.find("ftyp"));
+  ASSERT_NE(std::string::npos, top.find("meta"));
+  ASSERT_EQ(std::string::npos, top.find("hdlr"));
+
+  const std::string children = printStructure(1);
+  ASSERT_NE(std::string::npos, children.find("hdlr"));
+  ASSERT_NE(std::string::npos, children.find("iinf"));
+  ASSERT_EQ(std::string::npos, children.find("infe"));
+  ASSERT_NE(std::string::npos, printStructure(2).find("infe"));
+}
+
+#if defined(EXV_HAVE_BROTLI) && defined(EXV_HAVE_XMP_TOOLKIT)
+TEST_F(BmffImageTest, readMetadataUncompressesLargeBrotliBoxes) {
+  const std::string format(200 * 1024, 'x');
+  const auto file = jxlWithBrotliXmp(format);
+  BmffImage image(std::make_unique<MemIo>(file.data(), file.size()), false);
+  ASSERT_EQ(BmffImage::defaultBrotliMaxSize, image.brotliMaxSize());
+  image.readMetadata();
+  ASSERT_EQ(format, image.xmpData()["Xmp.dc.format"].toString());
+}
+
+TEST_F(BmffImageTest, readMetadataThrowsWhenABrotliBoxExceedsTheLimit) {
+  const auto file = jxlWithBrotliXmp(std::string(200 * 1024, 'x'));
+  BmffImage image(std::make_unique<MemIo>(file.data(), file.size()), false);
+  image.setBrotliMaxSize(100 * 1024);
+  try {
+    image.readMetadata();
+    FAIL();
+  } catch (const Exiv2::Error& e) {
+    ASSERT_EQ(ErrorCode::kerFailedToReadImageData, e.code());
+  }
+}
+#endif
@@ -9,14 +9,61 @@
 #include <cstdio>
 #include <filesystem>
 #include <fstream>
+#include <future>
 #include <stdexcept>
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include <gtest/gtest.h>
 
 namespace fs = std::filesystem;
 
 using namespace Exiv2;
 
+#ifdef __linux__
+namespace {
+//! Number of file descriptors open in this process
+size_t openDescriptors() {
+  return std::distance(fs::directory_iterator("/proc/self/fd"), fs::directory_iterator());
+}
+}  // namespace
+
+TEST(prefetchFile, closesItsDescriptorForRegularMissingAndRemoteFiles) {
+  const std::string path = (fs::path(TESTDATA_PATH) / "Reagan.jpg").string();
+  const size_t descriptors = openDescriptors();
+  for (int i = 0; i < 100; ++i) {
+    prefetchFile(path, 4096);
+    prefetchFile("nonExistingFile", 4096);
+    prefetchFile("http://www.exiv2.org/image.jpg", 4096);
+  }
+  ASSERT_EQ(descriptors, openDescriptors());
+}
+#endif
+
+#ifndef _WIN32
+TEST(prefetchFile, doesNotBlockOnAFifo) {
+  const std::string fifo("prefetchFile.fifo");
+  fs::remove(fifo);
+  ASSERT_EQ(0, ::mkfifo(fifo.c_str(), 0600));
+
+  auto prefetched = std::async(std::launch::async, [&fifo] { prefetchFile(fifo, 4096); });
+  const bool returned = prefetched.wait_for(std::chrono::seconds(5)) == std::future_status::ready;
+  if (!returned) {
+    // release the blocked reader, otherwise the future would wait for it forever
+    const int fd = ::open(fifo.c_str(), O_WRONLY | O_NONBLOCK);
+    if (fd >= 0)
+      ::close(fd);
+  }
+  prefetched.get();
+  fs::remove(fifo);
+  ASSERT_TRUE(returned);
+}
+#endif
+
 TEST(strError, returnSuccessAfterClosingFile) {
   // previous system calls can fail, but errno is not guaranteed to be reset
   // by a successful system call
@@ -4,7 +4,11 @@
 
 #include <gtest/gtest.h>
 
+#include <filesystem>
+#include <sstream>
+
 using namespace Exiv2;
+namespace fs = std::filesystem;
 
 TEST(Jp2Image, canBeCreatedFromScratch) {
   auto memIo = std::make_unique<MemIo>();
@@ -115,3 +119,21 @@ TEST(Jp2Image, canWriteMetadataAndReadAfterwards) {
   ASSERT_NO_THROW(image.writeMetadata());
   ASSERT_NO_THROW(image.readMetadata());
 }
+
+TEST(Jp2Image, printStructureHonoursTheDepthLimit) {
+  Jp2Image image(std::make_unique<FileIo>((fs::path(TESTDATA_PATH) / "Reagan.jp2").string()), false);
+  std::ostringstream all;
+  image.printStructure(all, kpsRecursive, 1);
+  ASSERT_NE(std::string::npos, all.str().find("sub:ihdr"));
+  ASSERT_NE(std::string::npos, all.str().find("STRUCTURE OF TIFF FILE"));
+
+  PrintStructureLimits limits;
+  limits.maxDepth_ = 0;
+  image.setPrintStructureLimits(limits);
+  std::ostringstream top;
+  image.printStructure(top, kpsRecursive, 1);
+  ASSERT_NE(std::string::npos, top.str().find("jp2h"));
+  ASSERT_NE(std::string::npos, top.str().find("Exif:"));
+  ASSERT_EQ(std::string::npos, top.str().find("sub:"));
+  ASSERT_EQ(std::string::npos, top.str().find("STRUCTURE OF TIFF FILE"));
+}
@@ -0,0 +1,55 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <exiv2/jpgimage.hpp>
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <sstream>
+
+using namespace Exiv2;
+namespace fs = std::filesystem;
+
+namespace {
+std::string printStructure(const PrintStructureLimits& limits) {
+  JpegImage image(std::make_unique<FileIo>((fs::path(TESTDATA_PATH) / "Reagan.jpg").string()), false);
+  image.setPrintStructureLimits(limits);
+  std::ostringstream out;
+  image.printStructure(out, kpsRecursive, 1);
+  return out.str();
+}
+
+size_t count(const std::string& text, const std::string& what) {
+  size_t n = 0;
+  for (auto pos = text.find(what); pos != std::string::npos; pos = text.find(what, pos + what.size()))
+    ++n;
+  return n;
+}
+}  // namespace
+
+TEST(JpegImage, printStructureHonoursTheIfdDepthLimit) {
+  // IFD0 of the Exif data and the Exif IFD it refers to
+  const std::string all = printStructure({});
+  ASSERT_EQ(2u, count(all, "STRUCTURE OF TIFF FILE"));
+  ASSERT_NE(std::string::npos, all.find("ExposureTime"));
+
+  PrintStructureLimits limits;
+  limits.maxDepth_ = 0;
+  const std::string top = printStructure(limits);
+  ASSERT_EQ(1u, count(top, "STRUCTURE OF TIFF FILE"));
+  ASSERT_NE(std::string::npos, top.find("ExifTag"));
+  ASSERT_EQ(std::string::npos, top.find("ExposureTime"));
+}
+
+TEST(JpegImage, printStructureHonoursTheByteLimit) {
+  const std::string all = printStructure({});
+  ASSERT_EQ(std::string::npos, all.find("byte limit reached"));
+
+  PrintStructureLimits limits;
+  limits.maxBytes_ = 0;
+  const std::string none = printStructure(limits);
+  ASSERT_EQ(1u, count(none, "byte limit reached"));
+  ASSERT_NE(std::string::npos, none.find("ImageWidth"));
+  ASSERT_EQ(std::string::npos, none.find("ExifTag"));
+  ASSERT_LT(none.size(), all.size());
+}
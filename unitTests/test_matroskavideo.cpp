@@ -52,4 +52,80 @@ TEST(MatroskaVideo, readMetadata) {
   auto data = mkv.xmpData();
   ASSERT_FALSE(data.empty());
   ASSERT_EQ(xmpData["Xmp.video.TotalStream"].count(), 4);
-}
\ No newline at end of file
+}
+
+TEST(MatroskaVideo, readMetadataFollowsSeekHeadPastCluster) {
+  // clang-format off
+  const std::array<byte, 50> data = {
+      0x1a, 0x45, 0xdf, 0xa3, 0x80,                          // EBML header
+      0x18, 0x53, 0x80, 0x67, 0xa8,                          // Segment
+      0x11, 0x4d, 0x9b, 0x74, 0x8e,                          //   SeekHead
+      0x4d, 0xbb, 0x8b,                                      //     Seek
+      0x53, 0xab, 0x84, 0x15, 0x49, 0xa9, 0x66,              //       SeekID: Info
+      0x53, 0xac, 0x81, 0x1c,                                //       SeekPosition
+      0x1f, 0x43, 0xb6, 0x75, 0x84, 0x00, 0x00, 0x00, 0x00,  //   Cluster
+      0x15, 0x49, 0xa9, 0x66, 0x87,                          //   Info
+      0x7b, 0xa9, 0x84, 'T', 'e', 's', 't',                  //     Title
+  };
+  // clang-format on
+  auto memIo = std::make_unique<MemIo>(data.data(), data.size());
+  MatroskaVideo mkv(std::move(memIo));
+  ASSERT_NO_THROW(mkv.readMetadata());
+  ASSERT_EQ("Test", mkv.xmpData()["Xmp.video.Title"].toString());
+}
+
+TEST(MatroskaVideo, readMetadataSkipsValuesLargerThanTheLimit) {
+  // clang-format off
+  const std::array<byte, 22> data = {
+      0x1a, 0x45, 0xdf, 0xa3, 0x80,  // EBML header
+      0x18, 0x53, 0x80, 0x67, 0x8c,  // Segment
+      0x15, 0x49, 0xa9, 0x66, 0x87,  //   Info
+      0x7b, 0xa9, 0x84, 'T', 'e', 's', 't',  // Title
+  };
+  // clang-format on
+  MatroskaVideo mkv(std::make_unique<MemIo>(data.data(), data.size()));
+  ASSERT_EQ(MatroskaVideo::defaultValueMaxSize, mkv.valueMaxSize());
+  mkv.readMetadata();
+  ASSERT_EQ("Test", mkv.xmpData()["Xmp.video.Title"].toString());
+
+  mkv.setValueMaxSize(3);
+  mkv.readMetadata();
+  ASSERT_EQ(mkv.xmpData().end(), mkv.xmpData().findKey(XmpKey("Xmp.video.Title")));
+}
+
+TEST(MatroskaVideo, attachmentWithoutMimeTypeIsNoPreview) {
+  // clang-format off
+  const std::array<byte, 48> data = {
+      0x1a, 0x45, 0xdf, 0xa3, 0x80,              // EBML header
+      0x18, 0x53, 0x80, 0x67, 0xa6,              // Segment
+      0x19, 0x41, 0xa4, 0x69, 0xa1,              //   Attachments
+      0x61, 0xa7, 0x94,                          //     AttachedFile
+      0x46, 0x60, 0x8a, 'i', 'm', 'a', 'g', 'e', '/', 'j', 'p', 'e', 'g',  // FileMimeType
+      0x46, 0x5c, 0x84, 0xff, 0xd8, 0xff, 0xd9,  //       FileData
+      0x61, 0xa7, 0x87,                          //     AttachedFile
+      0x46, 0x5c, 0x84, 0x00, 0x01, 0x02, 0x03,  //       FileData
+  };
+  // clang-format on
+  MatroskaVideo mkv(std::make_unique<MemIo>(data.data(), data.size()));
+  mkv.readMetadata();
+  ASSERT_EQ(1u, mkv.nativePreviews().size());
+  ASSERT_EQ(34u, mkv.nativePreviews().front().position_);
+  ASSERT_EQ(4u, mkv.nativePreviews().front().size_);
+}
+
+TEST(MatroskaVideo, readMetadataCountsTheTracksOfEachRead) {
+  // clang-format off
+  const std::array<byte, 20> data = {
+      0x1a, 0x45, 0xdf, 0xa3, 0x80,  // EBML header
+      0x18, 0x53, 0x80, 0x67, 0x8a,  // Segment
+      0x16, 0x54, 0xae, 0x6b, 0x85,  //   Tracks
+      0xae, 0x83,                    //     TrackEntry
+      0xd7, 0x81, 0x01,              //       TrackNumber
+  };
+  // clang-format on
+  MatroskaVideo mkv(std::make_unique<MemIo>(data.data(), data.size()));
+  mkv.readMetadata();
+  ASSERT_EQ(1, mkv.xmpData()["Xmp.video.TotalStream"].toInt64());
+  mkv.readMetadata();
+  ASSERT_EQ(1, mkv.xmpData()["Xmp.video.TotalStream"].toInt64());
+}
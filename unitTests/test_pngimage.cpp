@@ -86,6 +86,29 @@ TEST(PngImage, printStructurePrintsDataWithKpsBasic) {
   ASSERT_FALSE(stream.str().empty());
 }
 
+TEST(PngImage, printStructureHonoursLimits) {
+  auto memIo = std::make_unique<MemIo>();
+  const bool create{true};
+  PngImage png(std::move(memIo), create);
+
+  PrintStructureLimits limits;
+  limits.skipTypes_ = {"IHDR"};
+  png.setPrintStructureLimits(limits);
+  std::ostringstream skipped;
+  png.printStructure(skipped, Exiv2::kpsBasic, 1);
+  ASSERT_EQ(std::string::npos, skipped.str().find("IHDR"));
+  ASSERT_NE(std::string::npos, skipped.str().find("IEND"));
+
+  limits = {};
+  limits.maxEntries_ = 1;
+  png.setPrintStructureLimits(limits);
+  std::ostringstream truncated;
+  png.printStructure(truncated, Exiv2::kpsBasic, 1);
+  ASSERT_NE(std::string::npos, truncated.str().find("IHDR"));
+  ASSERT_NE(std::string::npos, truncated.str().find("more chunks"));
+  ASSERT_EQ(std::string::npos, truncated.str().find("IEND"));
+}
+
 TEST(PngImage, cannotReadMetadataFromEmptyIo) {
   auto memIo = std::make_unique<MemIo>();
   const bool create{false};
@@ -180,3 +203,55 @@ TEST(isPngType, withMemIoInErroneousStatusThrows) {
     ASSERT_EQ(ErrorCode::kerInputDataReadFailed, e.code());
   }
 }
+
+TEST(PngChunk, zlibCompressAndUncompressRoundTripLargeText) {
+  std::string text;
+  for (int i = 0; text.size() < 512 * 1024; ++i)
+    text += "<rdf:li>keyword " + std::to_string(i) + "</rdf:li>\n";
+
+  const std::string compressed = Internal::PngChunk::zlibCompress(text);
+  ASSERT_LT(compressed.size(), text.size());
+
+  DataBuf arr;
+  Internal::PngChunk::zlibUncompress(reinterpret_cast<const byte*>(compressed.data()), compressed.size(), arr);
+  ASSERT_EQ(text.size(), arr.size());
+  ASSERT_TRUE(std::equal(text.begin(), text.end(), arr.c_str()));
+}
+
+TEST(PngChunk, zlibUncompressThrowsWhenDataExceedsMaxSize) {
+  const std::string text(64 * 1024, 'x');
+  const std::string compressed = Internal::PngChunk::zlibCompress(text);
+
+  DataBuf arr;
+  ASSERT_THROW(Internal::PngChunk::zlibUncompress(reinterpret_cast<const byte*>(compressed.data()),
+                                                  compressed.size(), arr, text.size() - 1),
+               Exiv2::Error);
+  ASSERT_TRUE(Internal::PngChunk::zlibInflate(reinterpret_cast<const byte*>(compressed.data()), compressed.size(),
+                                              arr, text.size()));
+  ASSERT_EQ(text.size(), arr.size());
+}
+
+TEST(PngChunk, rawProfileRoundTripsAllByteValuesAndSizes) {
+  for (size_t size : {1, 2, 35, 36, 37, 71, 72, 73, 256, 1000, 4099}) {
+    std::string data(size, '\0');
+    for (size_t i = 0; i < size; ++i)
+      data[i] = static_cast<char>((i * 131 + size) & 0xff);
+
+    const std::string profile = Internal::PngChunk::writeRawProfile(data, "exif");
+    const DataBuf text(reinterpret_cast<const byte*>(profile.data()), profile.size());
+    const DataBuf decoded = Internal::PngChunk::readRawProfile(text, false);
+    ASSERT_EQ(size, decoded.size());
+    ASSERT_TRUE(std::equal(data.begin(), data.end(), decoded.c_str()));
+  }
+}
+
+TEST(PngChunk, readRawProfileSkipsSeparatorsInsideAndBetweenDigitPairs) {
+  const std::string profile = "\nexif\n       4\n0a b\nC0\n d 0ff\n";
+  const DataBuf text(reinterpret_cast<const byte*>(profile.data()), profile.size());
+  const DataBuf decoded = Internal::PngChunk::readRawProfile(text, false);
+  ASSERT_EQ(4, decoded.size());
+  ASSERT_EQ(0x0a, decoded.read_uint8(0));
+  ASSERT_EQ(0xbc, decoded.read_uint8(1));
+  ASSERT_EQ(0x0d, decoded.read_uint8(2));
+  ASSERT_EQ(0x0f, decoded.read_uint8(3));
+}
@@ -0,0 +1,52 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <exiv2/psdimage.hpp>  // Unit under test
+
+#include <exiv2/futils.hpp>
+#include <exiv2/image.hpp>
+#include <exiv2/types.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <filesystem>
+
+using namespace Exiv2;
+namespace fs = std::filesystem;
+
+namespace {
+//! Offset of the first byte after the image resource section of a PSD file
+size_t endOfResources(const DataBuf& psd) {
+  const size_t colorDataLength = psd.read_uint32(26, bigEndian);
+  const size_t resOffset = 30 + colorDataLength;
+  return resOffset + 4 + psd.read_uint32(resOffset, bigEndian);
+}
+
+void setCaption(const std::string& path, const std::string& caption) {
+  auto image = ImageFactory::open(path);
+  image->readMetadata();
+  image->iptcData()["Iptc.Application2.Caption"] = caption;
+  image->writeMetadata();
+}
+}  // namespace
+
+TEST(PsdImage, rewritesAResourceSectionOfTheSameSizeAndKeepsTheImageData) {
+  const std::string path("PsdImage_sameSize.psd");
+  fs::copy_file(fs::path(TESTDATA_PATH) / "20110626_213900.psd", path, fs::copy_options::overwrite_existing);
+
+  setCaption(path, "abc");
+  const DataBuf before = readFile(path);
+  setCaption(path, "xyz");
+  const DataBuf after = readFile(path);
+
+  ASSERT_EQ(before.size(), after.size());
+  const size_t end = endOfResources(before);
+  ASSERT_EQ(end, endOfResources(after));
+  ASSERT_FALSE(std::equal(before.cbegin(), before.cbegin() + end, after.cbegin()));
+  ASSERT_TRUE(std::equal(before.cbegin() + end, before.cend(), after.cbegin() + end));
+
+  auto image = ImageFactory::open(path);
+  image->readMetadata();
+  ASSERT_EQ("xyz", image->iptcData()["Iptc.Application2.Caption"].toString());
+  fs::remove(path);
+}
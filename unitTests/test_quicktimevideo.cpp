@@ -0,0 +1,142 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <exiv2/quicktimevideo.hpp>
+#include <vector>
+
+using namespace Exiv2;
+
+namespace {
+void appendUint32(std::vector<byte>& data, uint32_t value) {
+  byte buf[4];
+  ul2Data(buf, value, bigEndian);
+  data.insert(data.end(), buf, buf + 4);
+}
+
+std::vector<byte> box(const char* type, const std::vector<byte>& payload) {
+  std::vector<byte> data;
+  appendUint32(data, static_cast<uint32_t>(payload.size() + 8));
+  data.insert(data.end(), type, type + 4);
+  data.insert(data.end(), payload.begin(), payload.end());
+  return data;
+}
+
+std::vector<byte> words(std::initializer_list<uint32_t> values) {
+  std::vector<byte> data;
+  for (auto value : values)
+    appendUint32(data, value);
+  return data;
+}
+
+std::vector<byte> concat(std::initializer_list<std::vector<byte>> parts) {
+  std::vector<byte> data;
+  for (const auto& part : parts)
+    data.insert(data.end(), part.begin(), part.end());
+  return data;
+}
+
+uint32_t fourcc(const char* str) {
+  return getULong(reinterpret_cast<const byte*>(str), bigEndian);
+}
+
+//! CAMM position packet (type 5)
+std::vector<byte> cammPosition(double latitude, double longitude, double altitude) {
+  std::vector<byte> data(28);
+  us2Data(data.data() + 2, 5, littleEndian);
+  d2Data(data.data() + 4, latitude, littleEndian);
+  d2Data(data.data() + 12, longitude, littleEndian);
+  d2Data(data.data() + 20, altitude, littleEndian);
+  return data;
+}
+
+//! GPMF entry with 32-bit values
+std::vector<byte> gpmf(const char* key, uint8_t structSize, std::initializer_list<uint32_t> values) {
+  std::vector<byte> data(key, key + 4);
+  data.push_back(static_cast<byte>('l'));
+  data.push_back(structSize);
+  data.push_back(0);
+  data.push_back(static_cast<byte>(values.size() * 4 / structSize));
+  return concat({data, words(values)});
+}
+
+/*!
+  A QuickTime file with a timed metadata track of \em sampleCount samples of
+  \em sampleSize bytes, which are stored in one chunk at \em chunkOffset.
+  Each sample lasts half a second.
+ */
+std::vector<byte> metadataMovie(const char* handler, const char* format, uint32_t sampleSize, uint32_t sampleCount,
+                                uint32_t chunkOffset) {
+  const auto stbl = box(
+      "stbl", concat({
+                  box("stsd", concat({words({0, 1}), box(format, std::vector<byte>(8))})),
+                  box("stts", words({0, 1, sampleCount, 500})),
+                  box("stsc", words({0, 1, 1, sampleCount, 1})),
+                  box("stsz", words({0, sampleSize, sampleCount})),
+                  box("stco", words({0, 1, chunkOffset})),
+              }));
+  const auto mdia = box("mdia", concat({
+                                    box("mdhd", words({0, 0, 0, 1000, 1000, 0})),
+                                    box("hdlr", words({0, fourcc("mhlr"), fourcc(handler), 0, 0, 0})),
+                                    box("minf", stbl),
+                                }));
+  return concat({box("ftyp", words({fourcc("qt  "), 0, fourcc("qt  ")})), box("moov", box("trak", mdia))});
+}
+}  // namespace
+
+TEST(QuickTimeVideo, mimeTypeIsQuickTime) {
+  auto memIo = std::make_unique<MemIo>();
+  QuickTimeVideo qt(std::move(memIo));
+  ASSERT_EQ("video/quicktime", qt.mimeType());
+}
+
+TEST(QuickTimeVideo, readMetadataLocatesCammSamplesAndDecodesGpsTrack) {
+  const auto samples = concat({cammPosition(48.5, 9.25, 300), cammPosition(-33.75, 151.5, 20)});
+  const auto header = metadataMovie("camm", "camm", 28, 2, 0);
+  const auto chunkOffset = static_cast<uint32_t>(header.size() + 8);
+  const auto data = concat({metadataMovie("camm", "camm", 28, 2, chunkOffset), box("mdat", samples)});
+
+  QuickTimeVideo qt(std::make_unique<MemIo>(data.data(), data.size()));
+  ASSERT_NO_THROW(qt.readMetadata());
+
+  const auto& tracks = qt.timedMetadataTracks();
+  ASSERT_EQ(1u, tracks.size());
+  ASSERT_EQ("camm", tracks[0].format_);
+  ASSERT_EQ(2u, tracks[0].samples_.size());
+  ASSERT_EQ(header.size() + 8 + 28, tracks[0].samples_[1].offset_);
+  ASSERT_DOUBLE_EQ(0.5, tracks[0].samples_[1].time_);
+
+  const auto buffers = qt.readSamples(tracks[0], 0, 2);
+  ASSERT_EQ(2u, buffers.size());
+  ASSERT_EQ(0, std::memcmp(buffers[1].c_data(), samples.data() + 28, 28));
+
+  const auto gps = qt.gpsTrack();
+  ASSERT_EQ(2u, gps.size());
+  ASSERT_DOUBLE_EQ(48.5, gps[0].latitude_);
+  ASSERT_DOUBLE_EQ(151.5, gps[1].longitude_);
+  ASSERT_DOUBLE_EQ(20, gps[1].altitude_);
+  ASSERT_DOUBLE_EQ(0.5, gps[1].time_);
+}
+
+TEST(QuickTimeVideo, gpsTrackDecodesScaledGpmfPositions) {
+  const auto scal = gpmf("SCAL", 4, {10000000, 10000000, 1000});
+  const auto gps5 = gpmf("GPS5", 20, {485000000, 92500000, 300000, 0, 0, 485000100, 92500100, 301000, 0, 0});
+  const auto strm = std::vector<byte>{'S', 'T', 'R', 'M', 0, 1, 0, static_cast<byte>(scal.size() + gps5.size())};
+  const auto sample = concat({strm, scal, gps5});
+  const auto header = metadataMovie("meta", "gpmd", static_cast<uint32_t>(sample.size()), 1, 0);
+  const auto chunkOffset = static_cast<uint32_t>(header.size() + 8);
+  const auto data = concat({metadataMovie("meta", "gpmd", static_cast<uint32_t>(sample.size()), 1, chunkOffset),
+                            box("mdat", sample)});
+
+  QuickTimeVideo qt(std::make_unique<MemIo>(data.data(), data.size()));
+  ASSERT_NO_THROW(qt.readMetadata());
+
+  const auto gps = qt.gpsTrack();
+  ASSERT_EQ(2u, gps.size());
+  ASSERT_DOUBLE_EQ(48.5, gps[0].latitude_);
+  ASSERT_DOUBLE_EQ(9.25, gps[0].longitude_);
+  ASSERT_DOUBLE_EQ(300, gps[0].altitude_);
+  ASSERT_DOUBLE_EQ(0.25, gps[1].time_);
+  ASSERT_DOUBLE_EQ(301, gps[1].altitude_);
+}
@@ -4,9 +4,25 @@
 
 #include <array>
 #include <exiv2/riffvideo.hpp>
+#include <string>
 
 using namespace Exiv2;
 
+namespace {
+std::string chunk(const std::string& id, const std::string& payload) {
+  byte size[4];
+  ul2Data(size, static_cast<uint32_t>(payload.size()), littleEndian);
+  std::string data = id + std::string(reinterpret_cast<const char*>(size), 4) + payload;
+  if (payload.size() % 2)
+    data += '\0';
+  return data;
+}
+
+std::string list(const std::string& type, const std::string& chunks) {
+  return chunk("LIST", type + chunks);
+}
+}  // namespace
+
 TEST(RiffVideo, canBeOpenedWithEmptyMemIo) {
   auto memIo = std::make_unique<MemIo>();
   ASSERT_NO_THROW(RiffVideo riff(std::move(memIo)));
@@ -52,4 +68,48 @@ TEST(RiffVideo, readMetadata) {
   auto data = riff.xmpData();
   ASSERT_FALSE(data.empty());
   ASSERT_EQ(xmpData["Xmp.video.TotalStream"].count(), 4);
-}
\ No newline at end of file
+}
+
+TEST(RiffVideo, readMetadataSkipsMoviAndReadsTrailingInfoList) {
+  std::string avih(56, '\0');
+  avih[0] = 0x40;  // 40000 microseconds per frame
+  avih[1] = static_cast<char>(0x9c);
+  avih[32] = static_cast<char>(0x80);  // 640 x 480
+  avih[33] = 0x02;
+  avih[36] = static_cast<char>(0xe0);
+  avih[37] = 0x01;
+  // A list inside movi must not be taken for metadata
+  const std::string movi = chunk("00dc", std::string(1001, 'x')) + list("INFO", chunk("INAM", "Wrong"));
+  const std::string avi = "AVI " + list("hdrl", chunk("avih", avih)) + list("movi", movi) +
+                          chunk("idx1", std::string(16, '\0')) + list("INFO", chunk("INAM", "Right"));
+  const std::string riff = chunk("RIFF", avi);
+
+  RiffVideo video(std::make_unique<MemIo>(reinterpret_cast<const byte*>(riff.data()), riff.size()));
+  ASSERT_NO_THROW(video.readMetadata());
+  ASSERT_EQ("Right", video.xmpData()["Xmp.video.Title"].toString());
+  ASSERT_EQ(640, video.xmpData()["Xmp.video.Width"].toInt64());
+  ASSERT_EQ(40000, video.xmpData()["Xmp.video.MicroSecPerFrame"].toInt64());
+}
+
+TEST(RiffVideo, readMetadataReadsWordAlignedInfoChunks) {
+  const std::string info = list("INFO", chunk("INAM", "Odd") + chunk("IART", "Artist"));
+  const std::string riff = chunk("RIFF", "AVI " + info);
+
+  RiffVideo video(std::make_unique<MemIo>(reinterpret_cast<const byte*>(riff.data()), riff.size()));
+  ASSERT_NO_THROW(video.readMetadata());
+  ASSERT_EQ("Odd", video.xmpData()["Xmp.video.Title"].toString());
+  ASSERT_EQ("Artist", video.xmpData()["Xmp.video.Artist"].toString());
+}
+
+TEST(RiffVideo, readMetadataThrowsOnAnOversizedInfoChunk) {
+  const std::string oversized = std::string("INAM") + "\xf0\xff\xff\xff" + "Title";
+  const std::string riff = chunk("RIFF", "AVI " + list("INFO", oversized));
+
+  RiffVideo video(std::make_unique<MemIo>(reinterpret_cast<const byte*>(riff.data()), riff.size()));
+  try {
+    video.readMetadata();
+    FAIL() << "readMetadata did not throw";
+  } catch (const Error& e) {
+    ASSERT_EQ(ErrorCode::kerCorruptedMetadata, e.code());
+  }
+}
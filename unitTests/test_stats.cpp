@@ -0,0 +1,76 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <gtest/gtest.h>
+#include <exiv2/exiv2.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+
+using namespace Exiv2;
+
+namespace {
+const std::string testData(TESTDATA_PATH);
+
+bool hasPhase(const std::vector<Stats::Phase>& phases, const std::string& name) {
+  return std::any_of(phases.begin(), phases.end(), [&](const Stats::Phase& p) { return p.name_ == name; });
+}
+}  // namespace
+
+TEST(Stats, collectsNestedPhasesAndCountersForOneFile) {
+  Stats::reset();
+  auto image = ImageFactory::open(testData + "/Reagan.jpg");
+  image->readMetadata();
+
+  const auto phases = Stats::phases();
+  const auto counters = Stats::counters();
+  if (!Stats::enabled()) {
+    ASSERT_TRUE(phases.empty());
+    ASSERT_EQ(0u, counters.bytesRead_);
+    return;
+  }
+
+  ASSERT_TRUE(hasPhase(phases, "ImageFactory::open"));
+  ASSERT_TRUE(hasPhase(phases, "JpegBase::readMetadata"));
+  ASSERT_TRUE(hasPhase(phases, "JpegBase::readMetadata/TiffParserWorker::decode"));
+  for (const auto& phase : phases) {
+    ASSERT_EQ(phase.depth_, static_cast<size_t>(std::count(phase.name_.begin(), phase.name_.end(), '/')));
+    ASSERT_GT(phase.calls_, 0u);
+  }
+  ASSERT_GT(counters.reads_, 0u);
+  ASSERT_GT(counters.bytesRead_, 0u);
+  ASSERT_GT(counters.seeks_, 0u);
+
+  std::ostringstream os;
+  Stats::print(os);
+  ASSERT_NE(std::string::npos, os.str().find("TiffParserWorker::decode"));
+
+  Stats::reset();
+  ASSERT_TRUE(Stats::phases().empty());
+  ASSERT_EQ(0u, Stats::counters().reads_);
+}
+
+TEST(Stats, countsDataCopiedFromAnotherBasicIo) {
+  const byte data[] = {1, 2, 3, 4, 5, 6, 7, 8};
+  MemIo src(data, sizeof(data));
+  ASSERT_EQ(0, src.open());
+
+  Stats::reset();
+  MemIo memIo;
+  ASSERT_EQ(sizeof(data), memIo.write(src));
+  const std::string path("Stats_bulkWrite.bin");
+  FileIo fileIo(path);
+  ASSERT_EQ(0, fileIo.open("w+b"));
+  src.seek(0, BasicIo::beg);
+  ASSERT_EQ(sizeof(data), fileIo.write(src));
+  fileIo.close();
+  std::remove(path.c_str());
+
+  const auto counters = Stats::counters();
+  if (!Stats::enabled()) {
+    ASSERT_EQ(0u, counters.bytesWritten_);
+    return;
+  }
+  ASSERT_EQ(2u, counters.writes_);
+  ASSERT_EQ(2 * sizeof(data), counters.bytesWritten_);
+}
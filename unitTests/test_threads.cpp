@@ -0,0 +1,122 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <gtest/gtest.h>
+#include <exiv2/exiv2.hpp>
+
+#include <atomic>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace Exiv2;
+
+namespace {
+const std::string testData(TESTDATA_PATH);
+constexpr size_t threadCount = 8;
+constexpr size_t roundCount = 20;
+
+//! Read, modify, write and read back one image, return a description of the first mismatch
+std::string roundTrip(const DataBuf& file, const std::string& value) {
+  auto image = ImageFactory::open(file.c_data(), file.size());
+  image->readMetadata();
+  image->exifData()["Exif.Image.Artist"] = value;
+  image->iptcData()["Iptc.Application2.Byline"] = value;
+  image->xmpData()["Xmp.xmp.Label"] = value;
+  image->writeMetadata();
+
+  // the structure dump exercises the TIFF walker shared by all images
+  std::ostringstream structure;
+  image->printStructure(structure, kpsRecursive, 0);
+
+  BasicIo& io = image->io();
+  io.open();
+  const DataBuf written = io.read(io.size());
+  io.close();
+
+  auto reread = ImageFactory::open(written.c_data(), written.size());
+  reread->readMetadata();
+  if (reread->exifData()["Exif.Image.Artist"].toString() != value)
+    return "Exif mismatch for " + value;
+  if (reread->iptcData()["Iptc.Application2.Byline"].toString() != value)
+    return "IPTC mismatch for " + value;
+  if (reread->xmpData()["Xmp.xmp.Label"].toString() != value)
+    return "XMP mismatch for " + value;
+  return "";
+}
+
+std::atomic<size_t> logCount{0};
+
+void countingHandler(int, const char*) {
+  ++logCount;
+}
+}  // namespace
+
+TEST(Threads, readAndWriteDifferentImagesConcurrently) {
+  const DataBuf file = readFile(testData + "/Reagan.jpg");
+  std::vector<std::string> failures(threadCount);
+
+  std::vector<std::thread> workers;
+  for (size_t t = 0; t < threadCount; ++t) {
+    workers.emplace_back([&file, &failures, t] {
+      try {
+        for (size_t r = 0; r < roundCount && failures[t].empty(); ++r) {
+          failures[t] = roundTrip(file, "thread " + std::to_string(t) + " round " + std::to_string(r));
+        }
+      } catch (const Error& e) {
+        failures[t] = e.what();
+      }
+    });
+  }
+  for (auto& worker : workers)
+    worker.join();
+
+  for (const auto& failure : failures)
+    EXPECT_EQ("", failure);
+}
+
+TEST(Threads, changeTheLogSettingsAndInitializeXmpConcurrently) {
+  const DataBuf file = readFile(testData + "/Reagan.jpg");
+  const LogMsg::Level level = LogMsg::level();
+  const LogMsg::Handler handler = LogMsg::handler();
+  XmpParser::terminate();
+  std::vector<std::string> failures(threadCount);
+  std::atomic<bool> done{false};
+
+  // one thread keeps switching the log level and handler while the others log
+  std::thread logConfigurator([&done] {
+    const LogMsg::Level levels[] = {LogMsg::debug, LogMsg::warn, LogMsg::mute};
+    const LogMsg::Handler handlers[] = {countingHandler, nullptr};
+    for (size_t i = 0; !done; ++i) {
+      LogMsg::setLevel(levels[i % std::size(levels)]);
+      LogMsg::setHandler(handlers[i % std::size(handlers)]);
+    }
+  });
+
+  std::vector<std::thread> workers;
+  for (size_t t = 0; t < threadCount; ++t) {
+    workers.emplace_back([&file, &failures, t] {
+      try {
+        // all threads race to initialize the XMP toolkit
+        if (!XmpParser::initialize()) {
+          failures[t] = "XmpParser::initialize failed";
+          return;
+        }
+        for (size_t r = 0; r < roundCount && failures[t].empty(); ++r) {
+          LogMsg(LogMsg::warn).os() << "thread " << t << " round " << r;
+          failures[t] = roundTrip(file, "thread " + std::to_string(t) + " round " + std::to_string(r));
+        }
+      } catch (const Error& e) {
+        failures[t] = e.what();
+      }
+    });
+  }
+  for (auto& worker : workers)
+    worker.join();
+  done = true;
+  logConfigurator.join();
+  LogMsg::setLevel(level);
+  LogMsg::setHandler(handler);
+
+  for (const auto& failure : failures)
+    EXPECT_EQ("", failure);
+}
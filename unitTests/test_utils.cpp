@@ -14,6 +14,12 @@ TEST(stringUtils, startsWithReturnsFlase) {
   ASSERT_FALSE(startsWith("Exiv2 rocks", "exiv2"));
 }
 
+TEST(stringUtils, startsWithReturnsFalseForLongerPrefix) {
+  ASSERT_FALSE(startsWith("OLYMPUS", "OLYMPUS OPTICAL"));
+  ASSERT_TRUE(startsWith("OLYMPUS OPTICAL CO.,LTD", "OLYMPUS"));
+  ASSERT_FALSE(startsWith("NIKON OLYMPUS", "OLYMPUS"));
+}
+
 TEST(stringUtils, upperTransformStringToUpperCase) {
   ASSERT_EQ("EXIV2 ROCKS", upper("Exiv2 rocks"));
 }